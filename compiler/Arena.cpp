@@ -0,0 +1,37 @@
+#include "Arena.h"
+
+#include <cstdint>
+
+Arena::~Arena() {
+    release();
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (current == nullptr || address + size > reinterpret_cast<uintptr_t>(end)) {
+        // un gros objet a son propre bloc, sans abandonner la place libre du bloc courant
+        if (size + alignment > chunkSize / 4) {
+            void *chunk = ::operator new(size + alignment);
+            chunks.push_back(chunk);
+            return reinterpret_cast<void *>((reinterpret_cast<uintptr_t>(chunk) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        }
+        void *chunk = ::operator new(chunkSize);
+        chunks.push_back(chunk);
+        current = static_cast<char *>(chunk);
+        end = current + chunkSize;
+        address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    current = reinterpret_cast<char *>(address + size);
+    return reinterpret_cast<void *>(address);
+}
+
+void Arena::release() {
+    for (Destructor *destructor = destructors; destructor != nullptr; destructor = destructor->next)
+        destructor->destroy(destructor->object);
+    destructors = nullptr;
+    for (void *chunk : chunks)
+        ::operator delete(chunk);
+    chunks.clear();
+    current = nullptr;
+    end = nullptr;
+}
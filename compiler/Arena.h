@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/** Bump allocator owning the IR of a compilation unit
+
+   Objects are placed one after the other in large chunks and are never freed one by one:
+   release() (or the destructor) runs the destructors that matter, for objects holding
+   a std::string or a std::vector, then frees all the chunks at once.
+   ArenaAllocator lets the containers of the IR take their storage from the arena as well.
+*/
+class Arena {
+public:
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena();
+
+    void *allocate(size_t size, size_t alignment); /**< uninitialised memory, valid until release() */
+    template <typename T, typename... Args>
+    T *create(Args &&... args); /**< new T(args...) in the arena */
+    void release(); /**< destroys every object created in the arena and frees its memory */
+
+protected:
+    struct Destructor {
+        void (*destroy)(void *);
+        void *object;
+        Destructor *next;
+    };
+
+    static const size_t chunkSize = 64 * 1024;
+
+    vector<void *> chunks;
+    char *current = nullptr; /**< free space of the current chunk */
+    char *end = nullptr;
+    Destructor *destructors = nullptr; /**< objects to destroy, the most recent first */
+};
+
+template <typename T, typename... Args>
+T *Arena::create(Args &&... args) {
+    T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!is_trivially_destructible<T>::value) {
+        auto destructor = static_cast<Destructor *>(allocate(sizeof(Destructor), alignof(Destructor)));
+        destructor->destroy = [](void *o) { static_cast<T *>(o)->~T(); };
+        destructor->object = object;
+        destructor->next = destructors;
+        destructors = destructor;
+    }
+    return object;
+}
+
+/** STL allocator taking its memory from an Arena, deallocate() then does nothing.
+   Without an arena (objects built outside of a CFG, e.g. on the stack) it uses the heap. */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena *arena = nullptr) : arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        if (arena == nullptr)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, size_t) {
+        if (arena == nullptr)
+            ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+    Arena *arena;
+};
+
+template <typename T>
+using ArenaVector = vector<T, ArenaAllocator<T>>;
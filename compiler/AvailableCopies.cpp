@@ -0,0 +1,122 @@
+#include "AvailableCopies.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+AvailableCopies::Numbering AvailableCopies::numberCopies(CFG *cfg)
+{
+    // une copie dont la destination ou la source est réécrite plus loin dans son bloc n'en sort pas
+    vector<Copy> acrossBlocks;
+    vector<Copy> local;
+    for (auto bb : *cfg->bbs)
+    {
+        vector<Copy> pending;
+        unordered_map<int, vector<size_t>> pendingMentions;
+        vector<bool> killed;
+        for (auto instr : *bb->instrs)
+        {
+            int defined = instr->get_defined_var();
+            if (defined != 0)
+            {
+                for (size_t c : pendingMentions[defined])
+                    killed[c] = true;
+                pendingMentions.erase(defined);
+            }
+            if (instr->op != copyvar || !instr->params[1].is_variable() || instr->params[0] == instr->params[1])
+                continue;
+            Copy copy = {instr, instr->params[0].get_index(), instr->params[1].get_index()};
+            pendingMentions[copy.destination].push_back(pending.size());
+            pendingMentions[copy.source].push_back(pending.size());
+            pending.push_back(copy);
+            killed.push_back(false);
+        }
+        for (size_t c = 0; c < pending.size(); c++)
+            (killed[c] ? local : acrossBlocks).push_back(pending[c]);
+    }
+
+    Numbering numbering;
+    numbering.copies = acrossBlocks;
+    numbering.copies.insert(numbering.copies.end(), local.begin(), local.end());
+    numbering.acrossBlocks = min(acrossBlocks.size(), maxBits / max<size_t>(cfg->bbs->size(), 1));
+    return numbering;
+}
+
+AvailableCopies::AvailableCopies(CFG *cfg) : AvailableCopies(cfg, numberCopies(cfg)) {}
+
+AvailableCopies::AvailableCopies(CFG *cfg, Numbering numbering)
+    : Dataflow(cfg, numbering.acrossBlocks, FORWARD, INTERSECTION), copies(std::move(numbering.copies))
+{
+    for (size_t c = 0; c < copies.size(); c++)
+        numbers[copies[c].instr] = c;
+    for (size_t c = 0; c < universe; c++)
+    {
+        mentions[copies[c].destination].push_back(c);
+        mentions[copies[c].source].push_back(c);
+    }
+
+    gens.assign(blocks.size(), BitVector(universe));
+    kills.assign(blocks.size(), BitVector(universe));
+    unordered_set<int> defined;
+    for (size_t b = 0; b < blocks.size(); b++)
+    {
+        // gen : copies qui atteignent la fin du bloc, kill : copies dont une variable est écrite dans le bloc
+        Walk walk(*this, BitVector(copies.size()));
+        defined.clear();
+        for (auto instr : *blocks[b]->instrs)
+        {
+            walk.step(instr);
+            int var = instr->get_defined_var();
+            if (var == 0 || !defined.insert(var).second)
+                continue;
+            auto it = mentions.find(var);
+            if (it != mentions.end())
+                for (size_t c : it->second)
+                    kills[b].set(c);
+        }
+        walk.available.resize(universe);
+        gens[b] = walk.available;
+    }
+    solve();
+}
+
+AvailableCopies::Walk::Walk(const AvailableCopies &copies, BasicBlock *bb) : Walk(copies, copies.in(bb)) {}
+
+AvailableCopies::Walk::Walk(const AvailableCopies &copies, BitVector available) : copies(copies), available(std::move(available))
+{
+    this->available.for_each([&](size_t c)
+                             { make_available(c); });
+    this->available.resize(copies.copies.size());
+}
+
+int AvailableCopies::Walk::find_source(int var) const
+{
+    auto it = latest.find(var);
+    if (it == latest.end() || !available.test(it->second))
+        return 0;
+    return copies.copies[it->second].source;
+}
+
+void AvailableCopies::Walk::step(const IRInstr *instr)
+{
+    // seules les copies rendues disponibles pendant le parcours peuvent l'être : inutile de parcourir toutes celles de la variable
+    int defined = instr->get_defined_var();
+    auto killed = defined != 0 ? availableMentions.find(defined) : availableMentions.end();
+    if (killed != availableMentions.end())
+    {
+        for (size_t c : killed->second)
+            available.reset(c);
+        availableMentions.erase(killed);
+    }
+    auto copy = copies.numbers.find(instr);
+    if (copy != copies.numbers.end())
+        make_available(copy->second);
+}
+
+void AvailableCopies::Walk::make_available(size_t c)
+{
+    const Copy &copy = copies.copies[c];
+    available.set(c);
+    latest[copy.destination] = c;
+    availableMentions[copy.destination].push_back(c);
+    availableMentions[copy.source].push_back(c);
+}
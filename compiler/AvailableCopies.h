@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "Dataflow.h"
+
+using namespace std;
+
+/** Available copies of a CFG: the copies x = y such that x and y still hold the same value
+
+   A forward Dataflow analysis meeting by intersection: a copy is available at a point when it has
+   been executed on every path leading there, and neither its destination nor its source has been
+   written since. A read of x can then read y instead (copy propagation).
+   Each copy is recorded with the operands it had when the analysis was made: the passes rewriting
+   the instructions must use destination() and source(), not the operands of the copy.
+   As in Liveness, only the copies that reach the end of their block are in in() and out(), the
+   others only have a bit during the walk of their block (a Walk). The sets of all the blocks are
+   limited to maxBits: past it, the remaining copies are only propagated inside their block.
+
+   The analysis is solved by the constructor, on the CFG as it is then.
+*/
+class AvailableCopies : public Dataflow
+{
+public:
+    explicit AvailableCopies(CFG *cfg);
+
+    /** The instructions of a block, one after the other */
+    class Walk
+    {
+    public:
+        Walk(const AvailableCopies &copies, BasicBlock *bb);
+        int find_source(int var) const; /**< y for a copy var = y available before the current instruction, 0 if there is none */
+        void step(const IRInstr *instr); /**< to the next instruction */
+
+    protected:
+        friend class AvailableCopies;
+
+        Walk(const AvailableCopies &copies, BitVector available);
+        void make_available(size_t c);
+
+        const AvailableCopies &copies;
+        BitVector available;
+        unordered_map<int, size_t> latest; /**< variable -> the last copy writing it: at most one copy of a variable is available */
+        unordered_map<int, vector<size_t>> availableMentions; /**< variable -> the copies made available since, that mention it */
+    };
+
+    static const size_t maxBits = 1 << 26; /**< bits of the sets of all the blocks together */
+
+protected:
+    struct Copy
+    {
+        const IRInstr *instr;
+        int destination;
+        int source;
+    };
+
+    struct Numbering
+    {
+        vector<Copy> copies;
+        size_t acrossBlocks; /**< the first copies, which reach the end of their block */
+    };
+
+    AvailableCopies(CFG *cfg, Numbering numbering);
+    static Numbering numberCopies(CFG *cfg);
+
+    vector<Copy> copies; /**< by number */
+    unordered_map<const IRInstr *, size_t> numbers;
+    unordered_map<int, vector<size_t>> mentions; /**< variable -> the copies of in() and out() it is the destination or the source of */
+};
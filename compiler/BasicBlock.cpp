@@ -1,32 +1,95 @@
 #include "BasicBlock.h"
 
+#include <algorithm>
 #include <utility>
 
 BasicBlock::BasicBlock(CFG* cfg, string entry_label) :
     label(std::move(entry_label)),
-    cfg(cfg) {}
+    cfg(cfg),
+    instrs(cfg->arena->create<ArenaVector<IRInstr*>>(ArenaAllocator<IRInstr*>(cfg->arena))),
+    predecessors(cfg->arena->create<ArenaVector<BasicBlock*>>(ArenaAllocator<BasicBlock*>(cfg->arena))) {}
 
-void BasicBlock::gen_asm(ostream &o) const{
+// remplace la sortie exit par bb : une entrée de moins chez l'ancien successeur, une de plus chez le nouveau
+static void replace_exit(BasicBlock* block, BasicBlock*& exit, BasicBlock* bb){
+    if (exit == bb)
+        return;
+    if (exit != nullptr){
+        auto it = find(exit->predecessors->begin(), exit->predecessors->end(), block);
+        exit->predecessors->erase(it);
+    }
+    exit = bb;
+    if (bb != nullptr)
+        bb->predecessors->push_back(block);
+}
+
+void BasicBlock::set_exit_true(BasicBlock* bb){
+    replace_exit(this, exit_true, bb);
+}
+
+void BasicBlock::set_exit_false(BasicBlock* bb){
+    replace_exit(this, exit_false, bb);
+}
+
+void BasicBlock::detach(){
+    set_exit_true(nullptr);
+    set_exit_false(nullptr);
+}
+
+void BasicBlock::gen_asm(ostream &o, const BasicBlock* next) const{
     o << this->label << ":\n";
+
+    // a final comparison only read by the conditional jump sets the flags for it directly
+    IRInstr* comparison = nullptr;
+    Operand test_var = Operand::variable(test_var_index);
+    if (exit_false != nullptr && !instrs->empty() && instrs->back()->is_comparison()
+        && instrs->back()->get_defined_var() == test_var_index && cfg->get_read_count(test_var_index) == 1)
+        comparison = instrs->back();
+
     for (IRInstr* instr : *instrs){
-        instr->gen_asm(o);
+        if (instr != comparison)
+            instr->gen_asm(o);
     }
     
     if (exit_true == nullptr){
         cfg->gen_asm_epilogue(o);
     }
     else if (exit_false == nullptr){
-        IRInstr exit_instr = IRInstr(this, jump, {exit_true->label});
-        exit_instr.gen_asm(o);
+        if (exit_true != next){
+            IRInstr exit_instr = IRInstr(this, jump, {Operand::label(exit_true)});
+            exit_instr.gen_asm(o);
+        }
     }
     else{
-        o << "    cmpl $0, " << test_var_index << "(%rbp)" << endl;
-        o << "    je " << exit_false->label << endl;
-        IRInstr exit_instr = IRInstr(this, jump, {exit_true->label});
-        exit_instr.gen_asm(o);
+        // condition codes of the jump to exit_false, and of the jump to exit_true
+        string false_condition = "e";
+        string true_condition = "ne";
+        if (comparison != nullptr){
+            comparison->gen_asm_comparison(o);
+            false_condition = comparison->get_condition_code(true);
+            true_condition = comparison->get_condition_code();
+        }
+        else{
+            o << "    cmpl $0, " << cfg->IR_reg_to_asm(test_var) << endl;
+        }
+
+        if (exit_false == next){
+            // inverted condition, falling through to exit_false
+            o << "    j" << true_condition << " " << exit_true->label << endl;
+        }
+        else{
+            o << "    j" << false_condition << " " << exit_false->label << endl;
+            if (exit_true != next){
+                IRInstr exit_instr = IRInstr(this, jump, {Operand::label(exit_true)});
+                exit_instr.gen_asm(o);
+            }
+        }
     }
 }
 
-void BasicBlock::add_IRInstr(Operation op, vector<string> params) {
-    instrs->push_back(new IRInstr(this, op, std::move(params)));
+void BasicBlock::add_IRInstr(Operation op, initializer_list<Operand> params) {
+    instrs->push_back(cfg->create_instr(this, op, params));
+}
+
+void BasicBlock::add_IRInstr(Operation op, const vector<Operand> &params) {
+    instrs->push_back(cfg->create_instr(this, op, params));
 }
\ No newline at end of file
@@ -34,11 +34,14 @@ class IRInstr;
           an instruction comparing the value of tes_var_index to true is generated,
 					followed by a conditional branch to the exit_false branch,
 					followed by an unconditional branch to the exit_true branch
+	 No jump is generated to the block emitted right after this one (see IROptimizer::layoutBasicBlocks):
+	   when it is exit_false, the condition is inverted and the branch goes to exit_true.
 	 The attribute test_var_index itself is defined when converting 
   the if, while, etc of the AST  to IR.
 
-Possible optimization:
-     a cmp_* comparison instructions, if it is the last instruction of its block, 
+   Optimization:
+     a cmp_* comparison instruction, if it is the last instruction of its block
+       and its result is only read by the branch,
        generates an actual assembly comparison 
        followed by a conditional jump to the exit_false branch
 */
@@ -46,14 +49,21 @@ Possible optimization:
 class BasicBlock {
 public:
     BasicBlock(CFG* cfg, string entry_label);
-    void gen_asm(ostream &o) const; /**< x86 assembly code generation for this basic block (very simple) */
+    void gen_asm(ostream &o, const BasicBlock* next = nullptr) const; /**< x86 assembly code generation for this basic block, next is the block emitted right after it (no jump needed to reach it) */
 
-    void add_IRInstr(Operation op, vector<string> params);
+    void add_IRInstr(Operation op, initializer_list<Operand> params);
+    void add_IRInstr(Operation op, const vector<Operand> &params);
 
+    void set_exit_true(BasicBlock* bb);  /**< changes a successor, the predecessors of the old and new successors follow */
+    void set_exit_false(BasicBlock* bb);
+    void detach(); /**< removes both exits, for a block taken out of its CFG */
+
+    // les sorties ne sont modifiées que par set_exit_true / set_exit_false, qui tiennent à jour les prédécesseurs
     BasicBlock* exit_true = nullptr;  /**< pointer to the next basic block, true branch. If nullptr, return from procedure */
     BasicBlock* exit_false = nullptr; /**< pointer to the next basic block, false branch. If null_ptr, the basic block ends with an unconditional jump */
     string label; /**< label of the BB, also will be the label in the generated code */
     CFG* cfg; /** < the CFG where this block belongs */
-    vector<IRInstr*>* instrs = new vector<IRInstr*>; /** < the instructions themselves. */
+    ArenaVector<IRInstr*>* instrs; /** < the instructions themselves, allocated in the arena of the CFG. */
+    ArenaVector<BasicBlock*>* predecessors; /**< one entry per edge leading here: a branch with both exits to this block appears twice */
     int test_var_index;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "BitVector.h"
+
+BitVector::BitVector(size_t size, bool value) : bits(size), words((size + 63) / 64, value ? ~uint64_t(0) : 0)
+{
+    clearPadding();
+}
+
+void BitVector::fill(bool value)
+{
+    for (uint64_t &word : words)
+        word = value ? ~uint64_t(0) : 0;
+    clearPadding();
+}
+
+void BitVector::resize(size_t size)
+{
+    bits = size;
+    words.resize((size + 63) / 64, 0);
+    clearPadding();
+}
+
+size_t BitVector::count() const
+{
+    size_t count = 0;
+    for (uint64_t word : words)
+        count += __builtin_popcountll(word);
+    return count;
+}
+
+bool BitVector::unite(const BitVector &other)
+{
+    uint64_t changed = 0;
+    for (size_t w = 0; w < words.size(); w++)
+    {
+        uint64_t word = words[w] | other.words[w];
+        changed |= word ^ words[w];
+        words[w] = word;
+    }
+    return changed != 0;
+}
+
+bool BitVector::intersect(const BitVector &other)
+{
+    uint64_t changed = 0;
+    for (size_t w = 0; w < words.size(); w++)
+    {
+        uint64_t word = words[w] & other.words[w];
+        changed |= word ^ words[w];
+        words[w] = word;
+    }
+    return changed != 0;
+}
+
+void BitVector::subtract(const BitVector &other)
+{
+    for (size_t w = 0; w < words.size(); w++)
+        words[w] &= ~other.words[w];
+}
+
+void BitVector::clearPadding()
+{
+    if (bits % 64 != 0)
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+}
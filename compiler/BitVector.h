@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/** Dense set of the integers 0 .. size - 1, one bit each
+
+   The sets of the dataflow analyses: union, intersection and difference work a 64-bit word at a
+   time. Both operands of these operations must have the same size.
+*/
+class BitVector
+{
+public:
+    explicit BitVector(size_t size = 0, bool value = false);
+
+    size_t size() const { return bits; }
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+    void reset(size_t i) { words[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+    void fill(bool value); /**< every element in, or none */
+    void resize(size_t size); /**< keeps the elements below the new size, the new ones are not in the set */
+    size_t count() const;
+
+    bool unite(const BitVector &other); /**< this |= other, true if this changed */
+    bool intersect(const BitVector &other); /**< this &= other, true if this changed */
+    void subtract(const BitVector &other); /**< this &= ~other */
+
+    template <typename F>
+    void for_each(F f) const; /**< f(i) for each element, in increasing order */
+
+    bool operator==(const BitVector &other) const { return words == other.words; }
+    bool operator!=(const BitVector &other) const { return words != other.words; }
+
+protected:
+    void clearPadding(); /**< the bits past size() stay 0, so that == and count() can compare whole words */
+
+    size_t bits;
+    vector<uint64_t> words;
+};
+
+template <typename F>
+void BitVector::for_each(F f) const
+{
+    for (size_t w = 0; w < words.size(); w++)
+    {
+        uint64_t word = words[w];
+        while (word != 0)
+        {
+            f(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+}
@@ -1,18 +1,20 @@
 #include "CFG.h"
 
-CFG::CFG(string function_name) :
-    cfg_name(function_name)
+CFG::CFG(string function_name, Arena *arena) :
+    arena(arena),
+    cfg_name(function_name),
+    bbs(arena->create<ArenaVector<BasicBlock*>>(ArenaAllocator<BasicBlock*>(arena)))
     {
     add_symbol_context();
     string name_entry = new_BB_name();
     string name_exit = new_BB_name();
-    auto entryBB = new BasicBlock(this, name_entry);
-    auto exitBB = new BasicBlock(this, name_exit);
+    auto entryBB = create_bb(name_entry);
+    auto exitBB = create_bb(name_exit);
 
     add_bb(entryBB);
     add_bb(exitBB);
 
-    entryBB->exit_true = exitBB;
+    entryBB->set_exit_true(exitBB);
     
     current_bb = entryBB;
 }
@@ -21,11 +23,33 @@ void CFG::add_bb(BasicBlock *bb) {
     bbs->push_back(bb);
 }
 
+BasicBlock *CFG::create_bb(string label) {
+    return arena->create<BasicBlock>(this, std::move(label));
+}
+
+IRInstr *CFG::create_instr(BasicBlock *bb, Operation op, initializer_list<Operand> params) {
+    return arena->create<IRInstr>(bb, op, params, arena);
+}
+
+IRInstr *CFG::create_instr(BasicBlock *bb, Operation op, const vector<Operand> &params) {
+    return arena->create<IRInstr>(bb, op, params, arena);
+}
+
 void CFG::gen_asm(std::ostream &o) {
+    readCounts.clear();
+    for (auto bb : *bbs) {
+        for (auto instr : *bb->instrs)
+            for (int var : instr->get_used_vars())
+                readCounts[var]++;
+        if (bb->exit_false != nullptr)
+            readCounts[bb->test_var_index]++;
+    }
+
     gen_asm_prologue(o);
 
-    for (auto& bb : *bbs) {
-        bb->gen_asm(o);
+    // the entry block follows the prologue, each block may fall through to the next one
+    for (unsigned long i = 0; i < bbs->size(); i++) {
+        (*bbs)[i]->gen_asm(o, i + 1 < bbs->size() ? (*bbs)[i + 1] : nullptr);
     }
 }
 
@@ -34,45 +58,80 @@ void CFG::gen_asm_prologue(ostream &o) const {
     o << cfg_name <<": \n" ;
     o << "    pushq %rbp\n" ;
     o << "    movq %rsp, %rbp\n" ;
-    o << "    subq $"<< to_string(-nextFreeSymbolIndex) << ", %rsp\n" ;
+    o << "    subq $"<< to_string(get_frame_size()) << ", %rsp\n" ;
+    for (unsigned long i = 0; i < savedRegisters.size(); i++)
+        o << "    movq " << savedRegisters[i] << ", " << get_saved_register_offset(i) << "(%rbp)\n";
     for(const auto& pair : ParamNumber) {
-        string paramName = pair.first;
+        int symbolTableIndex = pair.first;
         int paramNumber = pair.second;
-        int symbolTableIndex = get_var_index(paramName);
         switch(paramNumber) {
             case 0:
-                o << "    movl %edi, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %edi, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             case 1:
-                o << "    movl %esi, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %esi, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             case 2:
-                o << "    movl %edx, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %edx, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             case 3:
-                o << "    movl %ecx, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %ecx, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             case 4:
-                o << "    movl %r8d, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %r8d, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             case 5:
-                o << "    movl %r9d, " << symbolTableIndex << "(%rbp)\n";
+                o << "    movl %r9d, " << IR_reg_to_asm(Operand::variable(symbolTableIndex)) << "\n";
                 break;
             default:
                 throw runtime_error("Unknown parameter number");
         }
     }
-    o << "    jmp "<< cfg_name<<"_bb0\n";
 }
 
 void CFG::gen_asm_epilogue(ostream &o) const{
+    for (unsigned long i = 0; i < savedRegisters.size(); i++)
+        o << "    movq " << get_saved_register_offset(i) << "(%rbp), " << savedRegisters[i] << "\n";
     o << "    movq %rbp, %rsp\n";
     o << "    popq %rbp\n" ;
     o << "    ret\n" ;
 }
 
-void CFG::add_to_symbol_table(const string & name, Type t) {
-    Symbols->back()->insert(make_pair(name, make_pair(t, nextFreeSymbolIndex)));
+string CFG::IR_reg_to_asm(const Operand & reg) const {
+    if (reg.is_immediate())
+        return "$" + to_string(reg.get_value());
+    auto it = registers.find(reg.get_index());
+    if (it != registers.end())
+        return it->second;
+    return to_string(reg.get_index()) + "(%rbp)";
+}
+
+bool CFG::is_in_register(const Operand & reg) const {
+    return reg.is_variable() && registers.find(reg.get_index()) != registers.end();
+}
+
+int CFG::get_read_count(int var) const {
+    auto it = readCounts.find(var);
+    return it == readCounts.end() ? 0 : it->second;
+}
+
+int CFG::get_frame_size() const {
+    if (savedRegisters.empty())
+        return -nextFreeSymbolIndex;
+    return -get_saved_register_offset(savedRegisters.size() - 1);
+}
+
+int CFG::get_saved_register_offset(int i) const {
+    // les registres sauvegardés (8 octets) sont rangés sous les variables locales
+    int localsSize = (-nextFreeSymbolIndex + 7) / 8 * 8;
+    return -(localsSize + 8 * (i + 1));
+}
+
+void CFG::add_to_symbol_table(int identifier, Type t) {
+    if (identifier >= (int)visibleSymbols.size())
+        visibleSymbols.resize(identifier + 1, -1);
+    Symbols.push_back(Symbol{t, nextFreeSymbolIndex, 0, identifier, visibleSymbols[identifier]});
+    visibleSymbols[identifier] = Symbols.size() - 1;
     nextFreeSymbolIndex -= get_type_size(t);
 }
 
@@ -85,43 +144,36 @@ size_t CFG::get_type_size(Type t) const {
     }
 }
 
-void CFG::add_param_to_symbol_table(const string & name, Type t, int paramNumber) {
+void CFG::add_param_to_symbol_table(int identifier, Type t, int paramNumber) {
     if(paramNumber < 6) {
-        add_to_symbol_table(name, t);
-        ParamNumber.insert(make_pair(name, paramNumber));
+        add_to_symbol_table(identifier, t);
+        Symbols.back().status = 1;
+        ParamNumber.push_back(make_pair(Symbols.back().index, paramNumber));
         return;
     }
-    Symbols->back()->insert(make_pair(name, make_pair(t, nextFreeParamIndex)));
+    if (identifier >= (int)visibleSymbols.size())
+        visibleSymbols.resize(identifier + 1, -1);
+    Symbols.push_back(Symbol{t, nextFreeParamIndex, 1, identifier, visibleSymbols[identifier]});
+    visibleSymbols[identifier] = Symbols.size() - 1;
     nextFreeParamIndex += get_type_size(t);
 }
 
-string CFG::create_new_tempvar(Type t) {
-    string name = "!tmp";
-    name.append(to_string(nextTmpVariableNumber));
-    nextTmpVariableNumber++;
-    add_to_symbol_table(name, t);
-    return name;
+int CFG::create_new_tempvar(Type t) {
+    int index = nextFreeSymbolIndex;
+    nextFreeSymbolIndex -= get_type_size(t);
+    return index;
 }
 
-int CFG::get_var_index(const string & name) const {
-    for (auto itContext = Symbols->rbegin(); itContext != Symbols->rend(); itContext++) {
-        auto it = (*itContext)->find(name);
-        if (it != (*itContext)->end()) {
-            return it->second.second;
-        }
-    }
-    return -1;
+Symbol *CFG::find_symbol(int identifier) {
+    if (identifier >= (int)visibleSymbols.size() || visibleSymbols[identifier] < 0)
+        return nullptr;
+    return &Symbols[visibleSymbols[identifier]];
 }
 
-Type CFG::get_var_type(const string & name) const {
-    for (auto itContext = Symbols->rbegin(); itContext != Symbols->rend(); itContext++) {
-        auto it = (*itContext)->find(name);
-        if (it != (*itContext)->end()) {
-            return it->second.first;
-        }
-    }
-    // Type of the variable not found -> Error
-    exit(6);
+int CFG::get_var_index(int identifier) const {
+    if (identifier >= (int)visibleSymbols.size() || visibleSymbols[identifier] < 0)
+        return -1;
+    return Symbols[visibleSymbols[identifier]].index;
 }
 
 string CFG::new_BB_name() {
@@ -138,17 +190,39 @@ string CFG::new_BB_name(string partOfName) {
     return name;
 }
 
+bool CFG::is_in_symbol_context(int identifier) const {
+    return identifier < (int)visibleSymbols.size() && visibleSymbols[identifier] >= (int)symbolContexts.back();
+}
+
+bool CFG::is_param(int identifier) const {
+    if (identifier >= (int)visibleSymbols.size())
+        return false;
+    int entry = visibleSymbols[identifier];
+    return entry >= 0 && (symbolContexts.size() < 2 || entry < (int)symbolContexts[1]);
+}
+
+size_t CFG::get_symbol_context_depth() const {
+    return symbolContexts.size();
+}
+
+vector<int> CFG::get_unused_variables() const {
+    vector<int> unused;
+    for (size_t i = symbolContexts.back(); i < Symbols.size(); i++) {
+        if (Symbols[i].status < 2)
+            unused.push_back(Symbols[i].identifier);
+    }
+    return unused;
+}
+
 void CFG::add_symbol_context() {
-    Symbols->push_back(new map<string, pair<Type, int>>());
+    symbolContexts.push_back(Symbols.size());
 }
 
 void CFG::end_symbol_context() {
-    Symbols->pop_back();
+    // le journal des déclarations : chaque entrée retirée rend visible celle qu'elle masquait
+    while (Symbols.size() > symbolContexts.back()) {
+        visibleSymbols[Symbols.back().identifier] = Symbols.back().shadowed;
+        Symbols.pop_back();
+    }
+    symbolContexts.pop_back();
 }
-
-BasicBlock* CFG::find_bb_by_name(string name){
-    for(auto bb : *bbs)
-        if (bb->label == name)
-            return bb;
-    return nullptr;
-}
\ No newline at end of file
@@ -7,12 +7,25 @@
 #include <map>
 
 #include "Type.h"
+#include "Operation.h"
+#include "Operand.h"
+#include "Arena.h"
 #include "BasicBlock.h"
 
 class BasicBlock;
+class IRInstr;
 
 using namespace std;
 
+/** Entry of the symbol table of a CFG */
+struct Symbol {
+    Type type;
+    int index; /**< offset from %rbp */
+    int status; /**< checked by CToIRVisitor: 0=declared, 1=initialised, 2=used */
+    int identifier; /**< interned name, see Identifiers */
+    int shadowed; /**< entry of the same name in an outer context, -1 if none */
+};
+
 /** The class for the control flow graph, also includes the symbol table */
 
 /* A few important comments:
@@ -23,9 +36,22 @@ using namespace std;
 
  */
 class CFG {
+    friend class AvailableCopies;
+    friend class CopyCoalescer;
+    friend class Dataflow;
     friend class IROptimizer;
+    friend class Liveness;
+    friend class LoopNest;
+    friend class LoopUnroller;
+    friend class RegisterAllocator;
+    friend class ScalarEvolution;
+    friend class SSA;
+    friend class ValueNumbering;
+    friend class DominatorTree;
+    friend class PassContext;
+    friend class PassManager;
     public:
-        explicit CFG(string function_name);
+        CFG(string function_name, Arena *arena);
 
         void add_bb(BasicBlock* bb);
 
@@ -33,31 +59,52 @@ class CFG {
         void gen_asm(ostream& o);
         void gen_asm_prologue(ostream& o) const;
         void gen_asm_epilogue(ostream& o) const;
+        string IR_reg_to_asm(const Operand & reg) const; /**< x86 operand of an IR operand: its register if allocated, else its stack slot (or $value for an immediate) */
+        bool is_in_register(const Operand & reg) const;
+        int get_read_count(int var) const; /**< number of instructions and conditional jumps reading this variable (valid during gen_asm) */
 
-        // symbol table methods
-        void add_to_symbol_table(const string & name, Type t);
-        void add_param_to_symbol_table(const string & name, Type t, int param_index);
-        string create_new_tempvar(Type t);
-        int get_var_index(const string & name) const;
-        Type get_var_type(const string & name) const;
+        // symbol table methods, the variables are named by their interned identifier
+        void add_to_symbol_table(int identifier, Type t);
+        void add_param_to_symbol_table(int identifier, Type t, int param_index);
+        int create_new_tempvar(Type t); /**< index of a new temporary, which has no name and is not in the symbol table */
+        int get_var_index(int identifier) const; /**< -1 if the variable is not in scope */
+        Symbol *find_symbol(int identifier); /**< innermost variable with this name, nullptr if there is none */
+        bool is_in_symbol_context(int identifier) const; /**< declared in the innermost context */
+        bool is_param(int identifier) const; /**< the innermost variable with this name is a parameter */
+        size_t get_symbol_context_depth() const; /**< 1 for the parameters, 2 in the bloc of the function */
+        vector<int> get_unused_variables() const; /**< identifiers of the variables of the innermost context that are never read */
         void add_symbol_context();
-        void end_symbol_context();
+        void end_symbol_context(); /**< forgets the variables of the innermost context, the shadowed ones are visible again */
         size_t get_type_size(Type t) const;
 
+        // IR allocation: the nodes are owned by the arena of this function (see SemanticChecker::begin_function),
+        // an Arena is not thread-safe and no two functions share one, so that functions can be optimized in parallel with -j
+        Arena *arena;
+        BasicBlock *create_bb(string label); /**< new basic block, to be added with add_bb */
+        IRInstr *create_instr(BasicBlock *bb, Operation op, initializer_list<Operand> params);
+        IRInstr *create_instr(BasicBlock *bb, Operation op, const vector<Operand> &params);
+
         // basic block management
         string new_BB_name();
         string new_BB_name(string partOfName);
         BasicBlock* current_bb = nullptr;
 
     protected:
-        vector<map <string, pair<Type,int>>*>* Symbols = new vector<map<string, pair<Type, int>>*>(); /**< Symbol table  */
-        map <string, int> ParamNumber; /**< param number for the first 6 params*/
+        // table des symboles à plat : entrer dans un bloc ou en sortir n'alloue rien
+        vector <Symbol> Symbols; /**< variables in scope, outermost context first (the parameters); leaving a context pops its entries */
+        vector <int> visibleSymbols; /**< by identifier: innermost entry of Symbols with this name, -1 if none */
+        vector <size_t> symbolContexts; /**< first entry of each context in Symbols */
+        vector <pair<int, int>> ParamNumber; /**< (variable index, param number) of the first 6 params */
         int nextFreeSymbolIndex = -4; /**< to allocate new symbols in the symbol table */
         int nextFreeParamIndex = 16;
         int nextBBnumber = 0; /**< just for naming */
-        int nextTmpVariableNumber = 0;
         string cfg_name;
+        map <int, string> registers; /**< variables placed in a register by the RegisterAllocator (index -> register) */
+        vector <string> savedRegisters; /**< callee-saved registers used by this function, saved in the prologue */
+        map <int, int> readCounts; /**< see get_read_count */
+
+        int get_frame_size() const;
+        int get_saved_register_offset(int i) const;
 
-        vector <BasicBlock*>* bbs = new vector<BasicBlock*>; /**< all the basic blocks of this CFG*/
-    BasicBlock *find_bb_by_name(string name);
+        ArenaVector <BasicBlock*>* bbs; /**< all the basic blocks of this CFG*/
 };
\ No newline at end of file
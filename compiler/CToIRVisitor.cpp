@@ -1,8 +1,9 @@
 #include "CToIRVisitor.h"
+#include "CompileError.h"
 
-CToIRVisitor::CToIRVisitor(vector<tuple<Type, string>> *definedFunctions)
+CToIRVisitor::CToIRVisitor(Arena *arena, ostream &diagnostics) :
+    identifiers(arena->create<Identifiers>()), checker(arena, identifiers, diagnostics)
 {
-    this->definedFunctions = definedFunctions;
     this->cfgs = new vector<CFG *>();
 }
 
@@ -12,29 +13,68 @@ void CToIRVisitor::add_cfg(CFG *newCfg)
     this->cfg = newCfg;
 }
 
-string CToIRVisitor::add_2op_instr(Operation op, antlr4::tree::ParseTree *left, antlr4::tree::ParseTree *right)
+Operand CToIRVisitor::add_2op_instr(Operation op, antlr4::tree::ParseTree *left, antlr4::tree::ParseTree *right)
 {
-    string variableName = cfg->create_new_tempvar(INT);
-    string variableIndex = to_string(cfg->get_var_index(variableName));
-    string leftOperandIndex = any_cast<string>(visit(left));
-    string rightOperandIndex = any_cast<string>(visit(right));
+    Operand variableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+    Operand leftOperandIndex = any_cast<Operand>(visit(left));
+    Operand rightOperandIndex = any_cast<Operand>(visit(right));
 
     cfg->current_bb->add_IRInstr(op, {variableIndex, leftOperandIndex, rightOperandIndex});
 
     return variableIndex;
 }
 
-antlrcpp::Any CToIRVisitor::visitFunction(ifccParser::FunctionContext *ctx)
+int CToIRVisitor::to_variable(const Operand &operand)
+{
+    if (!operand.is_immediate())
+        return operand.get_index();
+    int variableIndex = cfg->create_new_tempvar(INT);
+    cfg->current_bb->add_IRInstr(ldconst, {Operand::variable(variableIndex), operand});
+    return variableIndex;
+}
+
+Operand CToIRVisitor::use_variable(const string &name)
+{
+    return checker.use_variable(identifiers->intern(name));
+}
+
+void CToIRVisitor::check_void_call(antlr4::ParserRuleContext *ctx)
+{
+    for (auto child : ctx->children)
+    {
+        if (auto expr = dynamic_cast<ifccParser::ExprCALLContext *>(child))
+        {
+            checker.check_void_call(identifiers->intern(expr->ID()->getText()));
+        }
+    }
+}
+
+antlrcpp::Any CToIRVisitor::visitProg(ifccParser::ProgContext *ctx)
 {
-    string function_name = ctx->ID()->getText();
-    auto newCfg = new CFG(function_name);
+    // les en-têtes de toutes les fonctions sont relevés d'abord : un appel à une fonction définie plus loin n'est pas un @PLT
+    vector<ifccParser::FunctionContext *> functionContexts = ctx->function(); // function(i) parcourt les enfants à chaque appel
+    for (auto function : functionContexts)
+    {
+        Type functionType = function->type()->getText() == "int" ? Type::INT : Type::VOID;
+        checker.add_function(identifiers->intern(function->ID()->getText()), functionType, function->param().size());
+    }
+
+    for (auto function : functionContexts)
+    {
+        visit(function);
+    }
+
+    checker.check_main();
+    return 0;
+}
 
-    add_cfg(newCfg);
+antlrcpp::Any CToIRVisitor::visitFunction(ifccParser::FunctionContext *ctx)
+{
+    add_cfg(checker.begin_function(identifiers->intern(ctx->ID()->getText())));
 
     for (unsigned long i = 0; i < ctx->param().size(); i++)
     {
-        string paramName = ctx->param()[i]->ID()->getText();
-        newCfg->add_param_to_symbol_table(paramName, INT, i);
+        checker.add_param(identifiers->intern(ctx->param()[i]->ID()->getText()), i);
     }
 
     visit(ctx->bloc());
@@ -44,20 +84,22 @@ antlrcpp::Any CToIRVisitor::visitFunction(ifccParser::FunctionContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
 {
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
+    check_void_call(ctx);
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
     cfg->current_bb->add_IRInstr(ret, {variableIndex});
     return variableIndex;
 }
 
 antlrcpp::Any CToIRVisitor::visitDeclaration(ifccParser::DeclarationContext *ctx)
 {
-    string variableName = ctx->ID()->getText();
-    cfg->add_to_symbol_table(variableName, INT);
-    string variableIndex = to_string(cfg->get_var_index(variableName));
+    check_void_call(ctx);
+    int variable = identifiers->intern(ctx->ID()->getText());
+    Operand variableIndex = checker.declare_variable(variable);
 
     if (ctx->expression() != nullptr)
     {
-        string valueIndex = any_cast<string>(visit(ctx->expression()));
+        Operand valueIndex = any_cast<Operand>(visit(ctx->expression()));
+        checker.initialize_variable(variable);
         cfg->current_bb->add_IRInstr(copyvar, {variableIndex, valueIndex});
     }
 
@@ -66,10 +108,10 @@ antlrcpp::Any CToIRVisitor::visitDeclaration(ifccParser::DeclarationContext *ctx
 
 antlrcpp::Any CToIRVisitor::visitAffectation(ifccParser::AffectationContext *ctx)
 {
-    string variableName = ctx->ID()->getText();
-    string variableIndex = to_string(cfg->get_var_index(variableName));
-    string operandVariableIndex = any_cast<string>(visit(ctx->expression()));
-    vector<string> params = {variableIndex, operandVariableIndex};
+    check_void_call(ctx);
+    Operand variableIndex = checker.assign_variable(identifiers->intern(ctx->ID()->getText()));
+    Operand operandVariableIndex = any_cast<Operand>(visit(ctx->expression()));
+    vector<Operand> params = {variableIndex, operandVariableIndex};
 
     if (ctx->EQ() != nullptr)
     {
@@ -126,29 +168,20 @@ antlrcpp::Any CToIRVisitor::visitExprVAL(ifccParser::ExprVALContext *ctx)
 {
     if (ctx->valeur()->ID() != nullptr)
     {
-        return to_string(cfg->get_var_index(ctx->valeur()->ID()->getText()));
+        return use_variable(ctx->valeur()->ID()->getText());
     }
-    string variableName = cfg->create_new_tempvar(INT);
-    string variableIndex = to_string(cfg->get_var_index(variableName));
-    vector<string> params = {variableIndex};
-
+    // les constantes sont des opérandes immédiats, sans variable temporaire
     if (ctx->valeur()->CONST() != nullptr)
     {
-        params.push_back(ctx->valeur()->CONST()->getText());
-        cfg->current_bb->add_IRInstr(ldconst, params);
+        return Operand::immediate((int)stoll(ctx->valeur()->CONST()->getText()));
     }
-    else
-    {
-        int ascii_code = ctx->valeur()->CONSTCHAR()->getText()[1];
-        params.push_back(to_string(ascii_code));
-        cfg->current_bb->add_IRInstr(ldconst, params);
-    }
-
-    return variableIndex;
+    int ascii_code = ctx->valeur()->CONSTCHAR()->getText()[1];
+    return Operand::immediate(ascii_code);
 }
 
 antlrcpp::Any CToIRVisitor::visitExprMDM(ifccParser::ExprMDMContext *ctx)
 {
+    check_void_call(ctx);
     if (ctx->MULT() != nullptr)
     {
         return add_2op_instr(mul, ctx->expression()[0], ctx->expression()[1]);
@@ -165,6 +198,7 @@ antlrcpp::Any CToIRVisitor::visitExprMDM(ifccParser::ExprMDMContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprAS(ifccParser::ExprASContext *ctx)
 {
+    check_void_call(ctx);
     if (ctx->PLUS() != nullptr)
     {
         return add_2op_instr(add, ctx->expression()[0], ctx->expression()[1]);
@@ -177,14 +211,11 @@ antlrcpp::Any CToIRVisitor::visitExprAS(ifccParser::ExprASContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprUNAIRE(ifccParser::ExprUNAIREContext *ctx)
 {
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
+    check_void_call(ctx);
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
 
-    string tempVariable = cfg->create_new_tempvar(INT);
-    string tempVariableIndex = to_string(cfg->get_var_index(tempVariable));
-    vector<string> params = {tempVariableIndex, variableIndex};
-
-    cfg->current_bb->add_IRInstr(copyvar, params);
-    params = {tempVariableIndex};
+    Operand tempVariableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+    vector<Operand> params = {tempVariableIndex, variableIndex};
 
     if (ctx->MINUS() != nullptr)
     {
@@ -198,33 +229,38 @@ antlrcpp::Any CToIRVisitor::visitExprUNAIRE(ifccParser::ExprUNAIREContext *ctx)
     {
         cfg->current_bb->add_IRInstr(lnot, params);
     }
+    else
+    {
+        cfg->current_bb->add_IRInstr(copyvar, params);
+    }
 
     return tempVariableIndex;
 }
 
 antlrcpp::Any CToIRVisitor::visitIfelse(ifccParser::IfelseContext *ctx)
 {
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
-    cfg->current_bb->test_var_index = stoi(variableIndex);
+    check_void_call(ctx);
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
+    cfg->current_bb->test_var_index = to_variable(variableIndex);
 
     auto *bbIf = cfg->current_bb;
-    auto *bbTrue = new BasicBlock(cfg, cfg->new_BB_name("if_true"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("if_out"));
-    bbIf->exit_true = bbTrue;
+    auto *bbTrue = cfg->create_bb(cfg->new_BB_name("if_true"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("if_out"));
+    bbIf->set_exit_true(bbTrue);
 
     cfg->add_bb(bbTrue);
     cfg->current_bb = bbTrue;
     visit(ctx->condition_bloc()[0]);
-    cfg->current_bb->exit_true = bbOut;
+    cfg->current_bb->set_exit_true(bbOut);
 
     if (ctx->ELSE() == nullptr)
     {
-        bbIf->exit_false = bbOut;
+        bbIf->set_exit_false(bbOut);
     }
     else
     {
-        auto *bbFalse = new BasicBlock(cfg, cfg->new_BB_name("if_false"));
-        bbIf->exit_false = bbFalse;
+        auto *bbFalse = cfg->create_bb(cfg->new_BB_name("if_false"));
+        bbIf->set_exit_false(bbFalse);
 
         cfg->add_bb(bbFalse);
         cfg->current_bb = bbFalse;
@@ -236,7 +272,7 @@ antlrcpp::Any CToIRVisitor::visitIfelse(ifccParser::IfelseContext *ctx)
         {
             visit(ctx->condition_bloc()[1]);
         }
-        cfg->current_bb->exit_true = bbOut;
+        cfg->current_bb->set_exit_true(bbOut);
     }
     cfg->add_bb(bbOut);
     cfg->current_bb = bbOut;
@@ -246,27 +282,28 @@ antlrcpp::Any CToIRVisitor::visitIfelse(ifccParser::IfelseContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitWhile_loop(ifccParser::While_loopContext *ctx)
 {
-    auto *bbTest = new BasicBlock(cfg, cfg->new_BB_name("while_test"));
-    auto *bbBloc = new BasicBlock(cfg, cfg->new_BB_name("while_bloc"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("while_out"));
+    check_void_call(ctx);
+    auto *bbTest = cfg->create_bb(cfg->new_BB_name("while_test"));
+    auto *bbBloc = cfg->create_bb(cfg->new_BB_name("while_bloc"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("while_out"));
 
     cfg->add_bb(bbTest);
     cfg->add_bb(bbBloc);
     cfg->add_bb(bbOut);
 
-    cfg->current_bb->exit_true = bbTest;
+    cfg->current_bb->set_exit_true(bbTest);
     cfg->current_bb = bbTest;
-    bbTest->exit_true = bbBloc;
-    bbTest->exit_false = bbOut;
+    bbTest->set_exit_true(bbBloc);
+    bbTest->set_exit_false(bbOut);
 
     cfg->current_bb = bbTest;
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
-    cfg->current_bb->test_var_index = stoi(variableIndex);
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
+    cfg->current_bb->test_var_index = to_variable(variableIndex);
 
     pileBoucles.push(new pair<BasicBlock *, BasicBlock *>(bbTest, bbOut));
     cfg->current_bb = bbBloc;
     visit(ctx->condition_bloc());
-    cfg->current_bb->exit_true = bbTest;
+    cfg->current_bb->set_exit_true(bbTest);
     pileBoucles.pop();
 
     cfg->current_bb = bbOut;
@@ -276,6 +313,7 @@ antlrcpp::Any CToIRVisitor::visitWhile_loop(ifccParser::While_loopContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprEQ(ifccParser::ExprEQContext *ctx)
 {
+    check_void_call(ctx);
     if (ctx->EQEQ() != nullptr)
     {
         return add_2op_instr(cmp_eq, ctx->expression()[0], ctx->expression()[1]);
@@ -288,6 +326,7 @@ antlrcpp::Any CToIRVisitor::visitExprEQ(ifccParser::ExprEQContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprNE(ifccParser::ExprNEContext *ctx)
 {
+    check_void_call(ctx);
     if (ctx->GT() != nullptr)
     {
         return add_2op_instr(cmp_gt, ctx->expression()[0], ctx->expression()[1]);
@@ -308,16 +347,19 @@ antlrcpp::Any CToIRVisitor::visitExprNE(ifccParser::ExprNEContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprOR(ifccParser::ExprORContext *ctx)
 {
+    check_void_call(ctx);
     return add_2op_instr(bwor, ctx->expression()[0], ctx->expression()[1]);
 }
 
 antlrcpp::Any CToIRVisitor::visitExprAND(ifccParser::ExprANDContext *ctx)
 {
+    check_void_call(ctx);
     return add_2op_instr(bwand, ctx->expression()[0], ctx->expression()[1]);
 }
 
 antlrcpp::Any CToIRVisitor::visitExprXOR(ifccParser::ExprXORContext *ctx)
 {
+    check_void_call(ctx);
     return add_2op_instr(bwxor, ctx->expression()[0], ctx->expression()[1]);
 }
 
@@ -328,41 +370,42 @@ antlrcpp::Any CToIRVisitor::visitExprPARENS(ifccParser::ExprPARENSContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprNOT(ifccParser::ExprNOTContext *ctx)
 {
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
-    cfg->current_bb->add_IRInstr(lnot, {variableIndex});
-    return variableIndex;
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
+    Operand tempVariableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+    cfg->current_bb->add_IRInstr(lnot, {tempVariableIndex, variableIndex});
+    return tempVariableIndex;
 }
 
 antlrcpp::Any CToIRVisitor::visitExprLAND(ifccParser::ExprLANDContext *ctx)
 {
-    auto *bbTrueResult = new BasicBlock(cfg, cfg->new_BB_name("land_true_result"));
-    auto *bbTrue = new BasicBlock(cfg, cfg->new_BB_name("land_true"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("land_out"));
-    bbOut->exit_true = cfg->current_bb->exit_true;
-    bbOut->exit_false = cfg->current_bb->exit_false;
+    check_void_call(ctx);
+    auto *bbTrueResult = cfg->create_bb(cfg->new_BB_name("land_true_result"));
+    auto *bbTrue = cfg->create_bb(cfg->new_BB_name("land_true"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("land_out"));
+    bbOut->set_exit_true(cfg->current_bb->exit_true);
+    bbOut->set_exit_false(cfg->current_bb->exit_false);
 
     cfg->add_bb(bbTrueResult);
     cfg->add_bb(bbTrue);
     cfg->add_bb(bbOut);
 
-    string result = cfg->create_new_tempvar(INT);
-    string resultIndex = to_string(cfg->get_var_index(result));
+    Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
 
-    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, "0"});
-    string leftResultIndex = any_cast<string>(visit(ctx->expression()[0]));
-    cfg->current_bb->test_var_index = stoi(leftResultIndex);
-    cfg->current_bb->exit_true = bbTrue;
-    cfg->current_bb->exit_false = bbOut;
+    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(0)});
+    Operand leftResultIndex = any_cast<Operand>(visit(ctx->expression()[0]));
+    cfg->current_bb->test_var_index = to_variable(leftResultIndex);
+    cfg->current_bb->set_exit_true(bbTrue);
+    cfg->current_bb->set_exit_false(bbOut);
 
     cfg->current_bb = bbTrue;
-    string rightResultIndex = any_cast<string>(visit(ctx->expression()[1]));
-    cfg->current_bb->test_var_index = stoi(rightResultIndex);
-    cfg->current_bb->exit_true = bbTrueResult;
-    cfg->current_bb->exit_false = bbOut;
+    Operand rightResultIndex = any_cast<Operand>(visit(ctx->expression()[1]));
+    cfg->current_bb->test_var_index = to_variable(rightResultIndex);
+    cfg->current_bb->set_exit_true(bbTrueResult);
+    cfg->current_bb->set_exit_false(bbOut);
 
     cfg->current_bb = bbTrueResult;
-    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, "1"});
-    cfg->current_bb->exit_true = bbOut;
+    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(1)});
+    cfg->current_bb->set_exit_true(bbOut);
 
     cfg->current_bb = bbOut;
 
@@ -371,33 +414,33 @@ antlrcpp::Any CToIRVisitor::visitExprLAND(ifccParser::ExprLANDContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprLOR(ifccParser::ExprLORContext *ctx)
 {
-    auto *bbFalse = new BasicBlock(cfg, cfg->new_BB_name("lor_false"));
-    auto *bbTrueResult = new BasicBlock(cfg, cfg->new_BB_name("lor_true_result"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("lor_out"));
+    check_void_call(ctx);
+    auto *bbFalse = cfg->create_bb(cfg->new_BB_name("lor_false"));
+    auto *bbTrueResult = cfg->create_bb(cfg->new_BB_name("lor_true_result"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("lor_out"));
     cfg->add_bb(bbFalse);
     cfg->add_bb(bbTrueResult);
     cfg->add_bb(bbOut);
-    bbOut->exit_true = cfg->current_bb->exit_true;
-    bbOut->exit_false = cfg->current_bb->exit_false;
+    bbOut->set_exit_true(cfg->current_bb->exit_true);
+    bbOut->set_exit_false(cfg->current_bb->exit_false);
 
-    string result = cfg->create_new_tempvar(INT);
-    string resultIndex = to_string(cfg->get_var_index(result));
+    Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
 
-    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, "0"});
-    string leftResultIndex = any_cast<string>(visit(ctx->expression()[0]));
-    cfg->current_bb->test_var_index = stoi(leftResultIndex);
-    cfg->current_bb->exit_true = bbTrueResult;
-    cfg->current_bb->exit_false = bbFalse;
+    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(0)});
+    Operand leftResultIndex = any_cast<Operand>(visit(ctx->expression()[0]));
+    cfg->current_bb->test_var_index = to_variable(leftResultIndex);
+    cfg->current_bb->set_exit_true(bbTrueResult);
+    cfg->current_bb->set_exit_false(bbFalse);
 
     cfg->current_bb = bbFalse;
-    string rightResultIndex = any_cast<string>(visit(ctx->expression()[1]));
-    cfg->current_bb->test_var_index = stoi(rightResultIndex);
-    cfg->current_bb->exit_true = bbTrueResult;
-    cfg->current_bb->exit_false = bbOut;
+    Operand rightResultIndex = any_cast<Operand>(visit(ctx->expression()[1]));
+    cfg->current_bb->test_var_index = to_variable(rightResultIndex);
+    cfg->current_bb->set_exit_true(bbTrueResult);
+    cfg->current_bb->set_exit_false(bbOut);
 
     cfg->current_bb = bbTrueResult;
-    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, "1"});
-    cfg->current_bb->exit_true = bbOut;
+    cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(1)});
+    cfg->current_bb->set_exit_true(bbOut);
 
     cfg->current_bb = bbOut;
 
@@ -406,13 +449,17 @@ antlrcpp::Any CToIRVisitor::visitExprLOR(ifccParser::ExprLORContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitControl_flow_instruction(ifccParser::Control_flow_instructionContext *ctx)
 {
+    if (pileBoucles.empty())
+    {
+        throw CompileError(3, "Instruction " + ctx->getText() + " utilisée dans un contexte invalide");
+    }
     if (ctx->BREAK() != nullptr)
     {
-        cfg->current_bb->add_IRInstr(jump, {pileBoucles.top()->second->label});
+        cfg->current_bb->add_IRInstr(jump, {Operand::label(pileBoucles.top()->second)});
     }
     else
     {
-        cfg->current_bb->add_IRInstr(jump, {pileBoucles.top()->first->label});
+        cfg->current_bb->add_IRInstr(jump, {Operand::label(pileBoucles.top()->first)});
     }
     return 0;
 }
@@ -421,17 +468,15 @@ antlrcpp::Any CToIRVisitor::visitBloc(ifccParser::BlocContext *ctx)
 {
     cfg->add_symbol_context();
     visitChildren(ctx);
-    cfg->end_symbol_context();
+    checker.end_symbol_context();
     return 0;
 }
 
 antlrcpp::Any CToIRVisitor::visitExprPREFIX(ifccParser::ExprPREFIXContext *ctx)
 {
-    string variableName = ctx->ID()->getText();
-    string variableIndex = to_string(cfg->get_var_index(variableName));
+    Operand variableIndex = use_variable(ctx->ID()->getText());
 
-    string tempVariable = cfg->create_new_tempvar(INT);
-    string tempVariableIndex = to_string(cfg->get_var_index(tempVariable));
+    Operand tempVariableIndex = Operand::variable(cfg->create_new_tempvar(INT));
 
     if (ctx->PLUSPLUS() != nullptr)
     {
@@ -441,7 +486,7 @@ antlrcpp::Any CToIRVisitor::visitExprPREFIX(ifccParser::ExprPREFIXContext *ctx)
     {
         cfg->current_bb->add_IRInstr(decr, {variableIndex});
     }
-    vector<string> params = {tempVariableIndex, variableIndex};
+    vector<Operand> params = {tempVariableIndex, variableIndex};
     cfg->current_bb->add_IRInstr(copyvar, params);
 
     return tempVariableIndex;
@@ -449,13 +494,11 @@ antlrcpp::Any CToIRVisitor::visitExprPREFIX(ifccParser::ExprPREFIXContext *ctx)
 
 antlrcpp::Any CToIRVisitor::visitExprPOSTFIX(ifccParser::ExprPOSTFIXContext *ctx)
 {
-    string variableName = ctx->ID()->getText();
-    string variableIndex = to_string(cfg->get_var_index(variableName));
+    Operand variableIndex = use_variable(ctx->ID()->getText());
 
-    string result = cfg->create_new_tempvar(INT);
-    string resultIndex = to_string(cfg->get_var_index(result));
+    Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
 
-    vector<string> params = {resultIndex, variableIndex};
+    vector<Operand> params = {resultIndex, variableIndex};
     cfg->current_bb->add_IRInstr(copyvar, params);
     if (ctx->PLUSPLUS() != nullptr)
     {
@@ -470,6 +513,7 @@ antlrcpp::Any CToIRVisitor::visitExprPOSTFIX(ifccParser::ExprPOSTFIXContext *ctx
 
 antlrcpp::Any CToIRVisitor::visitExprBWSHIFT(ifccParser::ExprBWSHIFTContext *ctx)
 {
+    check_void_call(ctx);
     if (ctx->BWSL() != nullptr)
     {
         return add_2op_instr(bwsl, ctx->expression()[0], ctx->expression()[1]);
@@ -482,24 +526,18 @@ antlrcpp::Any CToIRVisitor::visitExprBWSHIFT(ifccParser::ExprBWSHIFTContext *ctx
 
 antlrcpp::Any CToIRVisitor::visitExprCALL(ifccParser::ExprCALLContext *ctx)
 {
-    string variableName = cfg->create_new_tempvar(INT);
-    string variableIndex = to_string(cfg->get_var_index(variableName));
-    string function_name = ctx->ID()->getText();
-
-    if (std::find_if(definedFunctions->begin(), definedFunctions->end(),
-                     [&function_name](const std::tuple<Type, std::string> &e)
-                     { return std::get<1>(e) == function_name; }) == definedFunctions->end())
-    {
-        function_name.append("@PLT");
-    }
+    check_void_call(ctx);
+    const FunctionInfo *callee = checker.check_call(identifiers->intern(ctx->ID()->getText()), ctx->expression().size());
+    Operand variableIndex = Operand::variable(cfg->create_new_tempvar(INT));
 
-    vector<string> params = vector<string>();
+    vector<Operand> params = vector<Operand>();
     params.push_back(variableIndex);
-    params.push_back(function_name);
+    // une fonction qui n'est pas définie dans le fichier est appelée par la PLT
+    params.push_back(callee != nullptr ? callee->symbol : Operand::function(ctx->ID()->getText() + "@PLT"));
 
     for (auto expr : ctx->expression())
     {
-        string param = any_cast<string>(visit(expr));
+        Operand param = any_cast<Operand>(visit(expr));
         params.push_back(param);
     }
     cfg->current_bb->add_IRInstr(call, params);
@@ -512,33 +550,33 @@ antlrcpp::Any CToIRVisitor::visitFor_loop(ifccParser::For_loopContext *ctx)
     cfg->add_symbol_context();
     if (ctx->for_init() != nullptr)
         visit(ctx->for_init());
-    auto *bbTest = new BasicBlock(cfg, cfg->new_BB_name("for_test"));
-    auto *bbBloc = new BasicBlock(cfg, cfg->new_BB_name("for_bloc"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("for_out"));
+    auto *bbTest = cfg->create_bb(cfg->new_BB_name("for_test"));
+    auto *bbBloc = cfg->create_bb(cfg->new_BB_name("for_bloc"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("for_out"));
 
     cfg->add_bb(bbTest);
     cfg->add_bb(bbBloc);
     cfg->add_bb(bbOut);
 
-    cfg->current_bb->exit_true = bbTest;
+    cfg->current_bb->set_exit_true(bbTest);
     cfg->current_bb = bbTest;
-    bbTest->exit_true = bbBloc;
-    bbTest->exit_false = bbOut;
+    bbTest->set_exit_true(bbBloc);
+    bbTest->set_exit_false(bbOut);
 
     cfg->current_bb = bbTest;
     if (ctx->for_test() != nullptr)
     {
-        string variableIndex = any_cast<string>(visit(ctx->for_test()));
-        cfg->current_bb->test_var_index = stoi(variableIndex);
+        Operand variableIndex = any_cast<Operand>(visit(ctx->for_test()));
+        cfg->current_bb->test_var_index = to_variable(variableIndex);
     }
     else
     {
-        bbTest->exit_false = nullptr;
+        bbTest->set_exit_false(nullptr);
     }
 
     if (ctx->for_after() != nullptr)
     {
-        auto *bbAfterBloc = new BasicBlock(cfg, cfg->new_BB_name("for_after"));
+        auto *bbAfterBloc = cfg->create_bb(cfg->new_BB_name("for_after"));
         cfg->add_bb(bbAfterBloc);
 
         pileBoucles.push(new pair<BasicBlock *, BasicBlock *>(bbAfterBloc, bbOut));
@@ -546,10 +584,10 @@ antlrcpp::Any CToIRVisitor::visitFor_loop(ifccParser::For_loopContext *ctx)
         visit(ctx->condition_bloc());
         pileBoucles.pop();
 
-        cfg->current_bb->exit_true = bbAfterBloc;
+        cfg->current_bb->set_exit_true(bbAfterBloc);
         cfg->current_bb = bbAfterBloc;
         visit(ctx->for_after());
-        cfg->current_bb->exit_true = bbTest;
+        cfg->current_bb->set_exit_true(bbTest);
     }
     else
     {
@@ -557,37 +595,37 @@ antlrcpp::Any CToIRVisitor::visitFor_loop(ifccParser::For_loopContext *ctx)
         cfg->current_bb = bbBloc;
         visit(ctx->condition_bloc());
         pileBoucles.pop();
-        cfg->current_bb->exit_true = bbTest;
+        cfg->current_bb->set_exit_true(bbTest);
     }
     cfg->current_bb = bbOut;
-    cfg->end_symbol_context();
+    checker.end_symbol_context();
     return 0;
 }
 
 antlrcpp::Any CToIRVisitor::visitDo_while_loop(ifccParser::Do_while_loopContext *ctx)
 {
-    auto *bbTest = new BasicBlock(cfg, cfg->new_BB_name("do_while_test"));
-    auto *bbBloc = new BasicBlock(cfg, cfg->new_BB_name("do_while_bloc"));
-    auto *bbOut = new BasicBlock(cfg, cfg->new_BB_name("do_while_out"));
+    auto *bbTest = cfg->create_bb(cfg->new_BB_name("do_while_test"));
+    auto *bbBloc = cfg->create_bb(cfg->new_BB_name("do_while_bloc"));
+    auto *bbOut = cfg->create_bb(cfg->new_BB_name("do_while_out"));
 
     cfg->add_bb(bbTest);
     cfg->add_bb(bbBloc);
     cfg->add_bb(bbOut);
 
-    cfg->current_bb->exit_true = bbBloc;
+    cfg->current_bb->set_exit_true(bbBloc);
     cfg->current_bb = bbTest;
-    bbTest->exit_true = bbBloc;
-    bbTest->exit_false = bbOut;
+    bbTest->set_exit_true(bbBloc);
+    bbTest->set_exit_false(bbOut);
 
     pileBoucles.push(new pair<BasicBlock *, BasicBlock *>(bbTest, bbOut));
     cfg->current_bb = bbBloc;
     visit(ctx->condition_bloc());
-    cfg->current_bb->exit_true = bbTest;
+    cfg->current_bb->set_exit_true(bbTest);
     pileBoucles.pop();
 
     cfg->current_bb = bbTest;
-    string variableIndex = any_cast<string>(visit(ctx->expression()));
-    cfg->current_bb->test_var_index = stoi(variableIndex);
+    Operand variableIndex = any_cast<Operand>(visit(ctx->expression()));
+    cfg->current_bb->test_var_index = to_variable(variableIndex);
 
     cfg->current_bb = bbOut;
     return 0;
@@ -3,16 +3,24 @@
 #include "antlr4-runtime.h"
 #include "generated/ifccBaseVisitor.h"
 #include "CFG.h"
+#include "Identifiers.h"
+#include "SemanticChecker.h"
 #include "Type.h"
 
 using namespace std;
 
+/** Checks the program and translates it into IR in a single walk of the parse tree
+
+   The checks that the grammar cannot express (declared variables, functions defined once...) are
+   done by the SemanticChecker while the IR is generated, on the names interned when they are met.
+*/
 class CToIRVisitor : public ifccBaseVisitor  {
 public :
-    CToIRVisitor(vector<tuple<Type,string>>* definedFunctions);
+    CToIRVisitor(Arena *arena, ostream &diagnostics = cerr);
     vector<CFG*>* cfgs; //current cfg
     CFG * cfg = nullptr;
 
+    antlrcpp::Any visitProg(ifccParser::ProgContext *ctx) override;
     antlrcpp::Any visitReturn_stmt(ifccParser::Return_stmtContext *ctx) override;
     antlrcpp::Any visitDeclaration(ifccParser::DeclarationContext *ctx) override;
     antlrcpp::Any visitAffectation(ifccParser::AffectationContext *ctx) override;
@@ -45,8 +53,12 @@ public :
     void add_cfg(CFG * newCfg);
 
 protected:
-    string add_2op_instr(Operation op, antlr4::tree::ParseTree* left, antlr4::tree::ParseTree* right);
+    Operand add_2op_instr(Operation op, antlr4::tree::ParseTree* left, antlr4::tree::ParseTree* right);
+    int to_variable(const Operand &operand); /**< index of a variable holding the operand, an immediate is loaded into a new temporary */
+    Operand use_variable(const string &name); /**< checks a variable read by an expression and returns it */
+    void check_void_call(antlr4::ParserRuleContext *ctx); /**< a void function may not be an operand */
     stack<pair<BasicBlock*, BasicBlock*>*> pileBoucles;
     // first -> continue, second -> break
-    vector<tuple<Type,string>>* definedFunctions;
+    Identifiers *identifiers; /**< names of the variables of the file, interned when they are met */
+    SemanticChecker checker;
 };
\ No newline at end of file
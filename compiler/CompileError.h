@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+/** Error stopping the compilation of a file
+
+   Thrown instead of calling exit() so that a process compiling several files (ifcc --batch)
+   only gives up on the faulty one: main prints the message and reports the status of the file.
+*/
+class CompileError : public runtime_error {
+public:
+    CompileError(int status, const string &message) : runtime_error(message), status(status) {}
+
+    int get_status() const { return status; } /**< exit status of ifcc for this error */
+
+protected:
+    int status;
+};
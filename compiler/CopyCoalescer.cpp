@@ -0,0 +1,124 @@
+#include "CopyCoalescer.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+
+#include "Liveness.h"
+
+CopyCoalescer::CopyCoalescer(CFG *cfg) : cfg(cfg) {}
+
+int CopyCoalescer::coalesce(const vector<IRInstr *> &copies)
+{
+    Liveness liveness(cfg);
+
+    // graphe d'interférence : une variable interfère avec celles vivantes là où elle est définie,
+    // sauf avec la source d'une copie qui la définit
+    map<int, set<int>> interferences;
+    auto interfere = [&interferences](int a, int b)
+    {
+        if (a == b)
+            return;
+        interferences[a].insert(b);
+        interferences[b].insert(a);
+    };
+    for (auto bb : *cfg->bbs)
+    {
+        BitVector live = liveness.live_after_instructions(bb);
+        for (auto it = bb->instrs->rbegin(); it != bb->instrs->rend(); it++)
+        {
+            IRInstr *instr = *it;
+            int defined = instr->get_defined_var();
+            if (defined != 0)
+                live.for_each([&](size_t n)
+                              {
+                                  int var = liveness.variable(n);
+                                  if (instr->op != copyvar || instr->params[1] != Operand::variable(var))
+                                      interfere(defined, var);
+                              });
+            liveness.step(instr, live);
+        }
+    }
+    // les variables vivantes à l'entrée de la fonction (paramètres) sont définies ensemble
+    vector<int> entryLive;
+    liveness.in(cfg->bbs->front()).for_each([&](size_t n)
+                                            { entryLive.push_back(liveness.variable(n)); });
+    for (int a : entryLive)
+        for (int b : entryLive)
+            interfere(a, b);
+
+    // les paramètres sont écrits par le prologue dans leur emplacement : ils ne peuvent pas être renommés
+    set<int> pinned;
+    for (const auto &param : cfg->ParamNumber)
+        pinned.insert(param.first);
+
+    // union-find : la racine d'un ensemble est celle qui a le plus de voisins (on fusionne le plus petit
+    // dans le plus grand), son nom la variable qui garde son emplacement
+    map<int, int> representative;
+    map<int, int> names;
+    function<int(int)> find = [&](int var) -> int
+    {
+        auto it = representative.find(var);
+        if (it == representative.end() || it->second == var)
+            return var;
+        return it->second = find(it->second);
+    };
+    auto nameOf = [&](int var)
+    {
+        int root = find(var);
+        auto it = names.find(root);
+        return it == names.end() ? root : it->second;
+    };
+
+    for (auto instr : copies)
+    {
+        if (instr->params[1].is_immediate())
+            continue;
+        int a = find(instr->params[0].get_index());
+        int b = find(instr->params[1].get_index());
+        if (a == b || interferences[a].count(b) != 0)
+            continue;
+        int nameA = nameOf(a);
+        int nameB = nameOf(b);
+        bool aPinned = pinned.count(nameA) != 0 || nameA > 0;
+        bool bPinned = pinned.count(nameB) != 0 || nameB > 0;
+        if (aPinned && bPinned)
+            continue;
+
+        // fusion de a dans b
+        if (interferences[a].size() > interferences[b].size())
+            swap(a, b);
+        representative[a] = b;
+        names[b] = aPinned ? nameA : nameB;
+        for (int neighbour : interferences[a])
+        {
+            interferences[neighbour].erase(a);
+            interferences[neighbour].insert(b);
+            interferences[b].insert(neighbour);
+        }
+        interferences.erase(a);
+    }
+
+    if (representative.empty())
+        return 0;
+    int removed = 0;
+    for (auto bb : *cfg->bbs)
+    {
+        for (auto instr : *bb->instrs)
+        {
+            for (unsigned long i : instr->get_source_indices())
+                if (instr->params[i].is_variable())
+                    instr->params[i] = Operand::variable(nameOf(instr->params[i].get_index()));
+            if (instr->get_defined_var() != 0)
+                instr->params[0] = Operand::variable(nameOf(instr->params[0].get_index()));
+        }
+        auto end = remove_if(bb->instrs->begin(), bb->instrs->end(), [](IRInstr *instr)
+                             { return instr->op == copyvar && instr->params[0] == instr->params[1]; });
+        removed += bb->instrs->end() - end;
+        bb->instrs->erase(end, bb->instrs->end());
+        if (bb->exit_false != nullptr)
+            bb->test_var_index = nameOf(bb->test_var_index);
+    }
+    return removed;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "CFG.h"
+
+using namespace std;
+
+/** Merges the variables related by copies when their lifetimes do not overlap (Chaitin)
+
+   Two variables interfere when one of them is defined where the other one is live (see Liveness),
+   except for the source of a copy that defines the other one. The copies are considered in the
+   given order: the destination and the source of a copy are merged when their sets of variables
+   do not interfere, the copy then disappears. The parameters keep their name, since the prologue
+   writes them in their own slot: two parameters are never merged.
+   Sound on any CFG, in SSA form or not; in SSA form, this is how SSA::destroy() removes most of the
+   copies of the phi instructions.
+*/
+class CopyCoalescer
+{
+public:
+    explicit CopyCoalescer(CFG *cfg);
+    int coalesce(const vector<IRInstr *> &copies); /**< number of copies removed */
+
+protected:
+    CFG *cfg;
+};
@@ -0,0 +1,106 @@
+#include "Dataflow.h"
+
+#include "DominatorTree.h"
+
+Dataflow::Dataflow(CFG *cfg, size_t universe, Direction direction, Meet meet)
+    : cfg(cfg), universe(universe), direction(direction), meet(meet), boundary(universe),
+      blocks(cfg->bbs->begin(), cfg->bbs->end())
+{
+    for (size_t i = 0; i < blocks.size(); i++)
+        indices[blocks[i]] = i;
+    succs.resize(blocks.size());
+    preds.resize(blocks.size());
+    for (size_t i = 0; i < blocks.size(); i++)
+        for (BasicBlock *succ : successors(blocks[i]))
+        {
+            auto it = indices.find(succ);
+            if (it == indices.end())
+                continue;
+            succs[i].push_back(it->second);
+            preds[it->second].push_back(i);
+        }
+
+    // valeur de départ : l'élément neutre de la rencontre, pour que le point fixe soit le plus précis
+    ins.assign(blocks.size(), BitVector(universe, meet == INTERSECTION));
+    outs.assign(blocks.size(), BitVector(universe, meet == INTERSECTION));
+}
+
+vector<BasicBlock *> Dataflow::successors(BasicBlock *bb)
+{
+    vector<BasicBlock *> succs = DominatorTree::successors(bb);
+    for (auto instr : *bb->instrs)
+        if (instr->op == jump)
+            succs.push_back(instr->params[0].get_block());
+    return succs;
+}
+
+bool Dataflow::solve(const function<bool()> &stop)
+{
+    bool forward = direction == FORWARD;
+    // valeur en entrée du bloc dans le sens de l'analyse, et valeur produite de l'autre côté
+    vector<BitVector> &before = forward ? ins : outs;
+    vector<BitVector> &after = forward ? outs : ins;
+    const vector<vector<size_t>> &sources = forward ? preds : succs;
+    const vector<vector<size_t>> &targets = forward ? succs : preds;
+
+    // en arrière, les derniers blocs d'abord : la plupart des valeurs sont alors justes dès le premier tour
+    vector<size_t> worklist;
+    vector<bool> listed(blocks.size(), true);
+    for (size_t i = 0; i < blocks.size(); i++)
+        worklist.push_back(forward ? blocks.size() - 1 - i : i);
+
+    BitVector value(universe);
+    size_t steps = 0;
+    while (!worklist.empty())
+    {
+        // l'horloge n'est lue que de temps en temps
+        if (stop && ++steps % 64 == 0 && stop())
+            return false;
+        size_t b = worklist.back();
+        worklist.pop_back();
+        listed[b] = false;
+
+        bool isBoundary = forward ? b == 0 : sources[b].empty();
+        if (isBoundary)
+            value = boundary;
+        else
+            value.fill(meet == INTERSECTION);
+        for (size_t source : sources[b])
+        {
+            if (meet == UNION)
+                value.unite(after[source]);
+            else
+                value.intersect(after[source]);
+        }
+        before[b] = value;
+
+        transfer(blocks[b], value);
+        if (value == after[b])
+            continue;
+        after[b] = value;
+        for (size_t target : targets[b])
+            if (!listed[target])
+            {
+                listed[target] = true;
+                worklist.push_back(target);
+            }
+    }
+    return true;
+}
+
+const BitVector &Dataflow::in(BasicBlock *bb) const
+{
+    return ins[index(bb)];
+}
+
+const BitVector &Dataflow::out(BasicBlock *bb) const
+{
+    return outs[index(bb)];
+}
+
+void Dataflow::transfer(BasicBlock *bb, BitVector &value) const
+{
+    size_t b = index(bb);
+    value.subtract(kills[b]);
+    value.unite(gens[b]);
+}
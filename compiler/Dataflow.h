@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "BitVector.h"
+#include "CFG.h"
+
+using namespace std;
+
+/** Iterative dataflow analysis over the blocks of a CFG
+
+   The facts are the elements of a BitVector of a fixed size (variables, instructions...), numbered
+   by the subclass. A forward analysis flows from the entry of the function along the exits of the
+   blocks, a backward one from the returns against them; the values meet at the joins by union
+   ("may" problems, such as liveness) or by intersection ("must" problems). The value is 'boundary'
+   at the entry of the function (forward) or at its returns (backward).
+
+   By default a block transforms a value x into gen | (x & ~kill), with gen and kill filled by the
+   subclass; an analysis whose effect is not a fixed set of facts per block overrides transfer().
+   solve() iterates with a worklist of blocks until no value changes: the transfer function must be
+   monotone. Its stop callback (the time budget of a pass) may end it before: the values are then
+   not a fixpoint and must not be used.
+
+   All the blocks of CFG::bbs are analysed, unreachable ones included. The jump instructions left
+   in a block (before IROptimizer::replaceJumpInstructions) are edges as well.
+*/
+class Dataflow
+{
+public:
+    enum Direction
+    {
+        FORWARD,
+        BACKWARD
+    };
+    enum Meet
+    {
+        UNION,
+        INTERSECTION
+    };
+
+    virtual ~Dataflow() = default;
+
+    bool solve(const function<bool()> &stop = nullptr); /**< false if stop() returned true before the fixpoint */
+    const BitVector &in(BasicBlock *bb) const; /**< value at the start of the block */
+    const BitVector &out(BasicBlock *bb) const; /**< value at the end of the block, before its branch */
+    size_t get_universe() const { return universe; }
+
+    static vector<BasicBlock *> successors(BasicBlock *bb); /**< exits and targets of the jump instructions */
+
+protected:
+    Dataflow(CFG *cfg, size_t universe, Direction direction, Meet meet);
+
+    virtual void transfer(BasicBlock *bb, BitVector &value) const; /**< value on the side of bb the analysis comes from -> value on the other side */
+    size_t index(BasicBlock *bb) const { return indices.at(bb); }
+
+    CFG *cfg;
+    size_t universe;
+    Direction direction;
+    Meet meet;
+    BitVector boundary;
+    vector<BasicBlock *> blocks; /**< CFG::bbs when the analysis was created */
+    unordered_map<BasicBlock *, size_t> indices;
+    vector<vector<size_t>> succs;
+    vector<vector<size_t>> preds;
+    vector<BitVector> ins;
+    vector<BitVector> outs;
+    vector<BitVector> gens; /**< left empty by the analyses that override transfer() */
+    vector<BitVector> kills;
+};
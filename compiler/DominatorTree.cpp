@@ -0,0 +1,155 @@
+#include "DominatorTree.h"
+
+#include <algorithm>
+
+DominatorTree::DominatorTree(CFG *cfg)
+{
+    computeReversePostorder(cfg->bbs->front());
+    computeIdoms();
+    computeFrontiers();
+}
+
+vector<BasicBlock *> DominatorTree::successors(BasicBlock *bb)
+{
+    vector<BasicBlock *> succs;
+    if (bb->exit_true != nullptr)
+        succs.push_back(bb->exit_true);
+    if (bb->exit_false != nullptr && bb->exit_false != bb->exit_true)
+        succs.push_back(bb->exit_false);
+    return succs;
+}
+
+void DominatorTree::computeReversePostorder(BasicBlock *entry)
+{
+    // parcours en profondeur itératif : les CFG générés peuvent être très profonds
+    vector<BasicBlock *> postorder;
+    set<BasicBlock *> visited;
+    vector<pair<BasicBlock *, unsigned long>> stack;
+    stack.emplace_back(entry, 0);
+    visited.insert(entry);
+    while (!stack.empty())
+    {
+        BasicBlock *bb = stack.back().first;
+        vector<BasicBlock *> succs = successors(bb);
+        if (stack.back().second < succs.size())
+        {
+            BasicBlock *succ = succs[stack.back().second++];
+            if (visited.insert(succ).second)
+                stack.emplace_back(succ, 0);
+            continue;
+        }
+        postorder.push_back(bb);
+        stack.pop_back();
+    }
+
+    reversePostorder.assign(postorder.rbegin(), postorder.rend());
+    for (unsigned long i = 0; i < reversePostorder.size(); i++)
+        order[reversePostorder[i]] = i;
+    for (auto bb : reversePostorder)
+        for (auto succ : successors(bb))
+            predecessors[succ].push_back(bb);
+}
+
+BasicBlock *DominatorTree::intersect(BasicBlock *a, BasicBlock *b) const
+{
+    while (a != b)
+    {
+        while (order.at(a) > order.at(b))
+            a = idoms.at(a);
+        while (order.at(b) > order.at(a))
+            b = idoms.at(b);
+    }
+    return a;
+}
+
+void DominatorTree::computeIdoms()
+{
+    BasicBlock *entry = reversePostorder.front();
+    idoms[entry] = entry;
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (unsigned long i = 1; i < reversePostorder.size(); i++)
+        {
+            BasicBlock *bb = reversePostorder[i];
+            BasicBlock *newIdom = nullptr;
+            for (auto pred : predecessors[bb])
+            {
+                if (idoms.find(pred) == idoms.end())
+                    continue;
+                newIdom = newIdom == nullptr ? pred : intersect(pred, newIdom);
+            }
+            if (idoms[bb] != newIdom)
+            {
+                idoms[bb] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    idoms[entry] = nullptr;
+    for (unsigned long i = 1; i < reversePostorder.size(); i++)
+        children[idoms[reversePostorder[i]]].push_back(reversePostorder[i]);
+}
+
+void DominatorTree::computeFrontiers()
+{
+    for (auto bb : reversePostorder)
+    {
+        if (predecessors[bb].size() < 2)
+            continue;
+        for (auto pred : predecessors[bb])
+        {
+            BasicBlock *runner = pred;
+            while (runner != idoms[bb])
+            {
+                vector<BasicBlock *> &frontier = frontiers[runner];
+                if (find(frontier.begin(), frontier.end(), bb) == frontier.end())
+                    frontier.push_back(bb);
+                runner = idoms[runner];
+            }
+        }
+    }
+    for (auto &frontier : frontiers)
+        sort(frontier.second.begin(), frontier.second.end(), [this](BasicBlock *a, BasicBlock *b)
+             { return order.at(a) < order.at(b); });
+}
+
+BasicBlock *DominatorTree::get_idom(BasicBlock *bb) const
+{
+    auto it = idoms.find(bb);
+    return it == idoms.end() ? nullptr : it->second;
+}
+
+const vector<BasicBlock *> &DominatorTree::get_children(BasicBlock *bb) const
+{
+    auto it = children.find(bb);
+    return it == children.end() ? empty : it->second;
+}
+
+const vector<BasicBlock *> &DominatorTree::get_frontier(BasicBlock *bb) const
+{
+    auto it = frontiers.find(bb);
+    return it == frontiers.end() ? empty : it->second;
+}
+
+const vector<BasicBlock *> &DominatorTree::get_predecessors(BasicBlock *bb) const
+{
+    auto it = predecessors.find(bb);
+    return it == predecessors.end() ? empty : it->second;
+}
+
+bool DominatorTree::is_reachable(BasicBlock *bb) const
+{
+    return order.find(bb) != order.end();
+}
+
+bool DominatorTree::dominates(BasicBlock *a, BasicBlock *b) const
+{
+    for (BasicBlock *runner = b; runner != nullptr; runner = get_idom(runner))
+        if (runner == a)
+            return true;
+    return false;
+}
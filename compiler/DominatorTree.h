@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "CFG.h"
+
+using namespace std;
+
+/** Dominator tree and dominance frontiers of a CFG
+
+   Computed with the iterative algorithm of Cooper, Harvey and Kennedy
+   ("A Simple, Fast Dominance Algorithm") on the reverse postorder of the blocks
+   reachable from the entry block (the first block of CFG::bbs).
+   Unreachable blocks do not appear in the tree.
+*/
+class DominatorTree
+{
+public:
+    explicit DominatorTree(CFG *cfg);
+
+    BasicBlock *get_idom(BasicBlock *bb) const; /**< immediate dominator, nullptr for the entry block */
+    const vector<BasicBlock *> &get_children(BasicBlock *bb) const; /**< blocks immediately dominated, in reverse postorder */
+    const vector<BasicBlock *> &get_frontier(BasicBlock *bb) const; /**< dominance frontier, in reverse postorder */
+    const vector<BasicBlock *> &get_predecessors(BasicBlock *bb) const; /**< reachable predecessors */
+    const vector<BasicBlock *> &get_reverse_postorder() const { return reversePostorder; }
+    bool dominates(BasicBlock *a, BasicBlock *b) const;
+    bool is_reachable(BasicBlock *bb) const;
+
+    static vector<BasicBlock *> successors(BasicBlock *bb);
+
+protected:
+    void computeReversePostorder(BasicBlock *entry);
+    void computeIdoms();
+    void computeFrontiers();
+    BasicBlock *intersect(BasicBlock *a, BasicBlock *b) const;
+
+    vector<BasicBlock *> reversePostorder;
+    map<BasicBlock *, int> order; /**< position of each block in reversePostorder */
+    map<BasicBlock *, BasicBlock *> idoms;
+    map<BasicBlock *, vector<BasicBlock *>> children;
+    map<BasicBlock *, vector<BasicBlock *>> frontiers;
+    map<BasicBlock *, vector<BasicBlock *>> predecessors;
+    vector<BasicBlock *> empty;
+};
@@ -0,0 +1,30 @@
+#include "FunctionTable.h"
+
+#include "CompileError.h"
+
+const FunctionInfo *FunctionTable::add(int identifier, const string &name, Type type, int arity) {
+    auto it = functions.find(identifier);
+    if (it == functions.end())
+        it = functions.emplace(identifier, FunctionInfo{type, arity, count, Operand::function(name)}).first;
+    count++;
+    return &it->second;
+}
+
+const FunctionInfo *FunctionTable::find(int identifier) const {
+    auto it = functions.find(identifier);
+    return it == functions.end() ? nullptr : &it->second;
+}
+
+const FunctionInfo *FunctionTable::check_call(int identifier, size_t arguments, size_t currentFunction) const {
+    const FunctionInfo *callee = find(identifier);
+    // int f() n'est pas un prototype en C : seul un appel à une fonction déjà rencontrée et qui a des paramètres est vérifié
+    if (callee != nullptr && callee->index <= currentFunction && callee->arity > 0 && (size_t)callee->arity != arguments)
+        throw CompileError(1, "Fonction " + callee->symbol.get_function_name() + " appelée avec " + to_string(arguments) + " arguments au lieu de " + to_string(callee->arity));
+    return callee;
+}
+
+void FunctionTable::check_void_call(int identifier, size_t currentFunction) const {
+    const FunctionInfo *callee = find(identifier);
+    if (callee != nullptr && callee->index <= currentFunction && callee->type == VOID)
+        throw CompileError(1, "Void function called in expression");
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "Operand.h"
+#include "Type.h"
+
+using namespace std;
+
+/** A function defined in the source file */
+struct FunctionInfo {
+    Type type;      /**< return type */
+    int arity;      /**< number of parameters */
+    size_t index;   /**< number of its first definition in the file */
+    Operand symbol; /**< its name for a call instruction, without @PLT */
+};
+
+/** Functions of a source file, indexed by the interned identifier of their name
+
+   Both front ends fill it with the headers of every function before translating any body: a call
+   then finds its callee (return type, number of parameters, symbol) in a single hashed lookup, to
+   check it and to choose between a function of the file and one of the library (@PLT). Only the
+   functions met so far, up to the current one, are checked: the others are not declared yet in C.
+*/
+class FunctionTable {
+public:
+    const FunctionInfo *add(int identifier, const string &name, Type type, int arity); /**< a later definition with the same name keeps the first one */
+    const FunctionInfo *find(int identifier) const; /**< nullptr if the file does not define it */
+    const FunctionInfo *check_call(int identifier, size_t arguments, size_t currentFunction) const; /**< the callee, nullptr for a library function; throws if it takes another number of arguments */
+    void check_void_call(int identifier, size_t currentFunction) const; /**< throws if a call used as an operand returns nothing */
+    size_t size() const { return count; } /**< number of definitions added, including the duplicates */
+
+protected:
+    unordered_map<int, FunctionInfo> functions;
+    size_t count = 0;
+};
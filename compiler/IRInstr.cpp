@@ -1,11 +1,15 @@
 #include "IRInstr.h"
 
-#include <utility>
 #include "BasicBlock.h"
+#include "CompileError.h"
 
-IRInstr::IRInstr(const BasicBlock *bb_, Operation op, vector<string> params) : bb(bb_),
-                                                                               op(op),
-                                                                               params(std::move(params)) {}
+IRInstr::IRInstr(const BasicBlock *bb_, Operation op, initializer_list<Operand> params, Arena *arena) : bb(bb_),
+                                                                                                        op(op),
+                                                                                                        params(params.begin(), params.end(), ArenaAllocator<Operand>(arena)) {}
+
+IRInstr::IRInstr(const BasicBlock *bb_, Operation op, const vector<Operand> &params, Arena *arena) : bb(bb_),
+                                                                                                     op(op),
+                                                                                                     params(params.begin(), params.end(), ArenaAllocator<Operand>(arena)) {}
 
 void IRInstr::gen_asm(ostream &o)
 {
@@ -20,55 +24,49 @@ void IRInstr::gen_asm(ostream &o)
     {
     case ldconst:
         // P0 = P1 (P1 CONST)
-        o << "    movl $" << params[1] << ", " << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case copyvar:
         // P0 = P1
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        if (bb->cfg->IR_reg_to_asm(params[0]) == bb->cfg->IR_reg_to_asm(params[1]))
+            break;
+        if (bb->cfg->is_in_register(params[0]) || bb->cfg->is_in_register(params[1]) || params[1].is_immediate())
+        {
+            // un seul accès mémoire : pas besoin de passer par %eax
+            o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
+            break;
+        }
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case add:
         // P0 = P1 + P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    addl " << params[2] << "(%rbp), %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    addl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case sub:
         // P0 = P1 - P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    subl " << params[2] << "(%rbp), %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    subl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case mul:
         // P0 = P1 * P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    imull " << params[2] << "(%rbp), %eax"
-          << "\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_multiplication(o);
         break;
     case divide:
         // P0 = P1 / P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cltd\n";
-        o << "    movl " << params[2] << "(%rbp), %ebx\n";
-        o << "    idivl %ebx\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
-        break;
     case modulo:
-        // P0 = P1 / P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cltd\n";
-        o << "    movl " << params[2] << "(%rbp), %ebx\n";
-        o << "    idivl %ebx\n";
-        o << "    movl %edx, " << params[0] << "(%rbp)\n";
+        // P0 = P1 % P2
+        gen_asm_division(o);
         break;
     case rmem:
         // /!\ non implémenté
-        exit(1);
-        break;
+        throw CompileError(1, "rmem is not implemented");
     case wmem:
         // /!\ non implémenté
-        exit(1);
+        throw CompileError(1, "wmem is not implemented");
         break;
     case call:
         // P0 = call P1(P2,...,Pn)
@@ -77,39 +75,39 @@ void IRInstr::gen_asm(ostream &o)
             switch (i)
             {
             case 2:
-                o << "    movl    " << params[i] << "(%rbp), %edi\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %edi\n";
                 break;
 
             case 3:
-                o << "    movl    " << params[i] << "(%rbp), %esi\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %esi\n";
                 break;
 
             case 4:
-                o << "    movl    " << params[i] << "(%rbp), %edx\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %edx\n";
                 break;
 
             case 5:
-                o << "    movl    " << params[i] << "(%rbp), %ecx\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %ecx\n";
                 break;
 
             case 6:
-                o << "    movl    " << params[i] << "(%rbp), %r8d\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %r8d\n";
                 break;
 
             case 7:
-                o << "    movl    " << params[i] << "(%rbp), %r9d\n";
+                o << "    movl    " << bb->cfg->IR_reg_to_asm(params[i]) << ", %r9d\n";
                 break;
 
             default:
                 o << "    subq $4" << ", %rsp\n";
-                o << "    movl " << params[params.size() - 1 + 8 - i] << "(%rbp), %eax\n";
+                o << "    movl " << bb->cfg->IR_reg_to_asm(params[params.size() - 1 + 8 - i]) << ", %eax\n";
                 o << "    movl %eax, (%rsp)\n";
                 break;
             }
         }
 
-        o << "    call    " << params[1] << "\n";
-        o << "    movl    %eax, " << params[0] << "(%rbp)\n";
+        o << "    call    " << params[1].get_function_name() << "\n";
+        o << "    movl    %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
 
         for (unsigned long i = params.size() - 1; i >= 8; i--)
         {
@@ -118,119 +116,423 @@ void IRInstr::gen_asm(ostream &o)
         break;
     case cmp_eq:
         // P0 = (P1 == P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    sete %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    sete %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case cmp_ne:
         // P0 = !(P1 == P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    setne %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    setne %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case cmp_lt:
         // P0 = (P1 < P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    setl %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    setl %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case cmp_le:
         // P0 = (P1 <= P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    setle %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    setle %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case cmp_gt:
         // P0 = (P1 > P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    setg %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    setg %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case cmp_ge:
         // P0 = (P1 >= P2)
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    cmp " << params[2] << "(%rbp), %eax\n";
-        o << "    setge %bl\n";
-        o << "    movzbl %bl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        gen_asm_comparison(o);
+        o << "    setge %al\n";
+        o << "    movzbl %al, %eax\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case ret:
         // return P0
-        o << "    movl " << params[0] << "(%rbp), %eax\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[0]) << ", %eax\n";
         break;
     case ret_cst:
         // return P0
-        o << "    movl $" << params[0] << ", %eax\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[0]) << ", %eax\n";
         break;
     case neg:
-        // P0 = -P0
-        o << "    neg " << params[0] << "(%rbp)\n";
+        // P0 = -P0 (P0 = -P1)
+        gen_asm_unary(o, "negl");
         break;
     case lnot:
-        // P0 = !P0
-        o << "    movl " << params[0] << "(%rbp), %eax\n";
+        // P0 = !P0 (P0 = !P1)
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params.back()) << ", %eax\n";
         o << "    test %eax, %eax\n";
         o << "    setz %al\n";
         o << "    movzbl %al, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case bwor:
         // P0 = P1 | P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    orl " << params[2] << "(%rbp), %eax\n";
-        o << "    movl %eax," << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    orl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "    movl %eax," << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case bwand:
         // P0 = P1 & P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    andl " << params[2] << "(%rbp), %eax\n";
-        o << "    movl %eax," << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    andl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "    movl %eax," << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case bwxor:
         // P0 = P1 ^ P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    xorl " << params[2] << "(%rbp), %eax\n";
-        o << "    movl %eax," << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    xorl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "    movl %eax," << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case bwnot:
-        // P0 = ~P0
-        o << "    not " << params[0] << "(%rbp)\n";
+        // P0 = ~P0 (P0 = ~P1)
+        gen_asm_unary(o, "notl");
         break;
     case jump:
         // jump P0;
-        o << "    jmp " << params[0] << "\n";
+        o << "    jmp " << params[0].get_block()->label << "\n";
         break;
     case incr:
-        // P0 = P0 + 1
-        o << "    incl " << params[0] << "(%rbp)\n";
+        // P0 = P0 + 1 (P0 = P1 + 1)
+        gen_asm_unary(o, "incl");
         break;
     case decr:
-        // P0 = P0 - 1
-        o << "    decl " << params[0] << "(%rbp)\n";
+        // P0 = P0 - 1 (P0 = P1 - 1)
+        gen_asm_unary(o, "decl");
         break;
+    case phi:
+        // les phi sont remplacés par des copies avant la génération de code (SSA::destroy)
+        throw runtime_error("phi instruction left in the IR");
     case bwsl:
         // P0 = P1 << P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    movl " << params[2] << "(%rbp), %ecx\n";
-        o << "    sall %cl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        if (params[2].is_immediate())
+        {
+            o << "    sall " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        }
+        else
+        {
+            o << "    movl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %ecx\n";
+            o << "    sall %cl, %eax\n";
+        }
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     case bwsr:
         // P0 = P1 >> P2
-        o << "    movl " << params[1] << "(%rbp), %eax\n";
-        o << "    movl " << params[2] << "(%rbp), %ecx\n";
-        o << "    sarl %cl, %eax\n";
-        o << "    movl %eax, " << params[0] << "(%rbp)\n";
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        if (params[2].is_immediate())
+        {
+            o << "    sarl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+        }
+        else
+        {
+            o << "    movl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %ecx\n";
+            o << "    sarl %cl, %eax\n";
+        }
+        o << "    movl %eax, " << bb->cfg->IR_reg_to_asm(params[0]) << "\n";
         break;
     }
+}
+
+void IRInstr::gen_asm_unary(ostream &o, const string &instruction)
+{
+    string dest = bb->cfg->IR_reg_to_asm(params[0]);
+    if (params.size() == 1 || params[1] == params[0])
+    {
+        o << "    " << instruction << " " << dest << "\n";
+        return;
+    }
+    o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+    o << "    " << instruction << " %eax\n";
+    o << "    movl %eax, " << dest << "\n";
+}
+
+void IRInstr::gen_asm_multiplication(ostream &o) const
+{
+    string dest = bb->cfg->IR_reg_to_asm(params[0]);
+    Operand factor = params[2], other = params[1];
+    if (other.is_immediate() && !factor.is_immediate())
+        swap(factor, other);
+    if (!factor.is_immediate() || other.is_immediate())
+    {
+        o << "    movl " << bb->cfg->IR_reg_to_asm(other) << ", %eax\n";
+        o << "    imull " << bb->cfg->IR_reg_to_asm(factor) << ", %eax\n";
+        o << "    movl %eax, " << dest << "\n";
+        return;
+    }
+
+    // facteur constant c = ±m * 2^k : m = 1, 3, 5 ou 9 donne au plus un lea, un décalage et une négation,
+    // moins coûteux qu'imull ; les autres facteurs gardent imull, sous sa forme à valeur immédiate
+    int value = factor.get_value();
+    if (value == 0)
+    {
+        o << "    movl $0, " << dest << "\n";
+        return;
+    }
+    unsigned odd = value < 0 ? 0u - value : value;
+    int shift = 0;
+    while (odd % 2 == 0)
+    {
+        odd /= 2;
+        shift++;
+    }
+    if (odd != 1 && odd != 3 && odd != 5 && odd != 9)
+    {
+        o << "    imull " << bb->cfg->IR_reg_to_asm(factor) << ", " << bb->cfg->IR_reg_to_asm(other) << ", %eax\n";
+        o << "    movl %eax, " << dest << "\n";
+        return;
+    }
+    o << "    movl " << bb->cfg->IR_reg_to_asm(other) << ", %eax\n";
+    if (odd != 1)
+        o << "    leal (%rax,%rax," << odd - 1 << "), %eax\n";
+    if (shift != 0)
+        o << "    sall $" << shift << ", %eax\n";
+    if (value < 0)
+        o << "    negl %eax\n";
+    o << "    movl %eax, " << dest << "\n";
+}
+
+void IRInstr::gen_asm_division(ostream &o) const
+{
+    string dest = bb->cfg->IR_reg_to_asm(params[0]);
+    int divisor = params[2].is_immediate() ? params[2].get_value() : 0;
+    if (divisor == 0 || params[1].is_immediate())
+    {
+        // idivl : quotient dans %eax, reste dans %edx
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "    cltd\n";
+        gen_asm_divisor(o);
+        o << "    movl " << (op == divide ? "%eax" : "%edx") << ", " << dest << "\n";
+        return;
+    }
+
+    // diviseur constant : pas d'idivl (20 à 40 cycles), le quotient arrondi vers zéro comme en C
+    string dividend = bb->cfg->IR_reg_to_asm(params[1]);
+    unsigned magnitude = divisor < 0 ? 0u - divisor : divisor;
+    if (magnitude == 1)
+    {
+        if (op == modulo)
+            o << "    movl $0, " << dest << "\n";
+        else
+        {
+            o << "    movl " << dividend << ", %eax\n";
+            if (divisor < 0)
+                o << "    negl %eax\n";
+            o << "    movl %eax, " << dest << "\n";
+        }
+        return;
+    }
+    if ((magnitude & (magnitude - 1)) == 0)
+    {
+        // x / 2^k = (x + (x < 0 ? 2^k - 1 : 0)) >> k, et x % 2^k = ((x + biais) & (2^k - 1)) - biais
+        int shift = 0;
+        while ((1u << shift) != magnitude)
+            shift++;
+        o << "    movl " << dividend << ", %eax\n";
+        o << "    cltd\n";
+        o << "    shrl $" << 32 - shift << ", %edx\n";
+        o << "    addl %edx, %eax\n";
+        if (op == divide)
+        {
+            o << "    sarl $" << shift << ", %eax\n";
+            if (divisor < 0)
+                o << "    negl %eax\n";
+        }
+        else
+        {
+            o << "    andl $" << magnitude - 1 << ", %eax\n";
+            o << "    subl %edx, %eax\n";
+        }
+        o << "    movl %eax, " << dest << "\n";
+        return;
+    }
+
+    // q = (x * M) >> (32 + s), corrigé de x quand M n'a pas le signe du diviseur, plus 1 si q < 0 (Hacker's Delight, 10-1)
+    int magic, shift;
+    signed_magic(divisor, magic, shift);
+    o << "    movl " << dividend << ", %ecx\n";
+    o << "    movl $" << magic << ", %eax\n";
+    o << "    imull %ecx\n";
+    if (divisor > 0 && magic < 0)
+        o << "    addl %ecx, %edx\n";
+    if (divisor < 0 && magic > 0)
+        o << "    subl %ecx, %edx\n";
+    if (shift != 0)
+        o << "    sarl $" << shift << ", %edx\n";
+    o << "    movl %edx, %eax\n";
+    o << "    shrl $31, %eax\n";
+    o << "    addl %eax, %edx\n";
+    if (op == divide)
+    {
+        o << "    movl %edx, " << dest << "\n";
+        return;
+    }
+    // x % d = x - q * d
+    o << "    imull $" << divisor << ", %edx, %edx\n";
+    o << "    movl %ecx, %eax\n";
+    o << "    subl %edx, %eax\n";
+    o << "    movl %eax, " << dest << "\n";
+}
+
+void IRInstr::signed_magic(int divisor, int &magic, int &shift)
+{
+    // plus petit p >= 32 tel que 2^p > nc * (d - 2^p mod d), nc le plus grand dividende tel que nc mod d = d - 1
+    const unsigned two31 = 0x80000000u;
+    unsigned magnitude = divisor < 0 ? 0u - divisor : divisor;
+    unsigned t = two31 + ((unsigned)divisor >> 31);
+    unsigned nc = t - 1 - t % magnitude;
+    int p = 31;
+    unsigned q1 = two31 / nc, r1 = two31 - q1 * nc;
+    unsigned q2 = two31 / magnitude, r2 = two31 - q2 * magnitude;
+    unsigned delta;
+    do
+    {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= nc)
+        {
+            q1++;
+            r1 -= nc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= magnitude)
+        {
+            q2++;
+            r2 -= magnitude;
+        }
+        delta = magnitude - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    magic = q2 + 1;
+    if (divisor < 0)
+        magic = -magic;
+    shift = p - 32;
+}
+
+void IRInstr::gen_asm_divisor(ostream &o) const
+{
+    // idivl n'accepte pas de valeur immédiate
+    if (params[2].is_immediate())
+    {
+        o << "    movl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %ecx\n";
+        o << "    idivl %ecx\n";
+        return;
+    }
+    o << "    idivl " << bb->cfg->IR_reg_to_asm(params[2]) << "\n";
+}
+
+void IRInstr::gen_asm_comparison(ostream &o) const
+{
+    // flags positionnés par P1 - P2
+    if (bb->cfg->is_in_register(params[1]))
+    {
+        o << "    cmpl " << bb->cfg->IR_reg_to_asm(params[2]) << ", " << bb->cfg->IR_reg_to_asm(params[1]) << "\n";
+        return;
+    }
+    o << "    movl " << bb->cfg->IR_reg_to_asm(params[1]) << ", %eax\n";
+    o << "    cmpl " << bb->cfg->IR_reg_to_asm(params[2]) << ", %eax\n";
+}
+
+bool IRInstr::is_comparison() const
+{
+    return op == cmp_eq || op == cmp_ne || op == cmp_lt || op == cmp_le || op == cmp_gt || op == cmp_ge;
+}
+
+string IRInstr::get_condition_code(bool negated) const
+{
+    switch (op)
+    {
+    case cmp_eq:
+        return negated ? "ne" : "e";
+    case cmp_ne:
+        return negated ? "e" : "ne";
+    case cmp_lt:
+        return negated ? "ge" : "l";
+    case cmp_le:
+        return negated ? "g" : "le";
+    case cmp_gt:
+        return negated ? "le" : "g";
+    case cmp_ge:
+        return negated ? "l" : "ge";
+    default:
+        throw runtime_error("not a comparison");
+    }
+}
+
+vector<int> IRInstr::get_used_vars() const
+{
+    vector<int> used;
+    for (unsigned long i : get_source_indices())
+        if (params[i].is_variable())
+            used.push_back(params[i].get_index());
+    return used;
+}
+
+vector<unsigned long> IRInstr::get_source_indices() const
+{
+    vector<unsigned long> indices;
+    switch (op)
+    {
+    case ldconst:
+    case jump:
+    case ret_cst:
+    case rmem:
+    case wmem:
+        break;
+    case copyvar:
+        indices.push_back(1);
+        break;
+    case ret:
+        indices.push_back(0);
+        break;
+    case neg:
+    case lnot:
+    case bwnot:
+    case incr:
+    case decr:
+        // P0 = op P0, ou P0 = op P1
+        indices.push_back(params.size() - 1);
+        break;
+    case call:
+        // P0 = call P1(P2,...,Pn)
+        for (unsigned long i = 2; i < params.size(); i++)
+            indices.push_back(i);
+        break;
+    case phi:
+        // P0 = phi(P1: P2, P3: P4, ...) : labels des prédécesseurs et variables
+        for (unsigned long i = 2; i < params.size(); i += 2)
+            indices.push_back(i);
+        break;
+    default:
+        // instructions à 3 opérandes : P0 = P1 op P2
+        indices.push_back(1);
+        indices.push_back(2);
+    }
+    return indices;
+}
+
+int IRInstr::get_defined_var() const
+{
+    switch (op)
+    {
+    case jump:
+    case ret:
+    case ret_cst:
+    case rmem:
+    case wmem:
+        return 0;
+    default:
+        return params[0].get_index();
+    }
 }
\ No newline at end of file
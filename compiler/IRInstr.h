@@ -7,6 +7,8 @@
 
 #include "Type.h"
 #include "Operation.h"
+#include "Operand.h"
+#include "Arena.h"
 
 class BasicBlock;
 class CFG;
@@ -14,14 +16,40 @@ class CFG;
 using namespace std;
 
 class IRInstr {
+    friend class AvailableCopies;
+    friend class CopyCoalescer;
+    friend class Dataflow;
     friend class IROptimizer;
+    friend class Liveness;
+    friend class LoopNest;
+    friend class LoopUnroller;
+    friend class RegisterAllocator;
+    friend class ScalarEvolution;
+    friend class SSA;
+    friend class ValueNumbering;
     public:
-        IRInstr(const BasicBlock* bb_, Operation op, vector<string> params);
+        IRInstr(const BasicBlock* bb_, Operation op, initializer_list<Operand> params, Arena *arena = nullptr);
+        IRInstr(const BasicBlock* bb_, Operation op, const vector<Operand> &params, Arena *arena = nullptr); /**< params are stored in the arena if any, see CFG::create_instr */
         void gen_asm(ostream &o); /**< x86 assembly code generation for this IR instruction */
+        vector<int> get_used_vars() const; /**< variables read by this instruction (immediate operands excluded) */
+        vector<unsigned long> get_source_indices() const; /**< indices in params of the operands read by this instruction */
+        int get_defined_var() const; /**< variable written by this instruction, 0 if none (no variable lives at offset 0) */
+
+        bool is_comparison() const; /**< true for the cmp_* instructions */
+        void gen_asm_comparison(ostream &o) const; /**< x86 flags of a cmp_* instruction, without materializing its result */
+        string get_condition_code(bool negated = false) const; /**< x86 condition code suffix (e, l, ge...) of a cmp_* instruction */
 
     private:
+        void gen_asm_unary(ostream &o, const string &instruction); /**< in-place x86 instruction on P0, after copying P1 into it if present */
+        void gen_asm_multiplication(ostream &o) const; /**< imull, or lea, shifts and negl for a constant factor */
+        void gen_asm_division(ostream &o) const; /**< idivl, or a multiplication by a magic number (shifts for a power of two) for a constant divisor */
+        void gen_asm_divisor(ostream &o) const; /**< idivl by P2, through %ecx when P2 is an immediate */
+        static void signed_magic(int divisor, int &magic, int &shift); /**< x / divisor = high 32 bits of x * magic, shifted right by shift, with its corrections (2 <= |divisor|, not a power of two) */
+
         const BasicBlock* bb; /**< The BB this instruction belongs to, which provides a pointer to the CFG this instruction belong to */
         Operation op;
-        vector<string> params; /**< For 3-op instrs: d, x, y; for ldconst: d, c;  For call: label, d, params;  for wmem and rmem: choose yourself */
+        ArenaVector<Operand> params; /**< For 3-op instrs: d, x, y; for ldconst: d, c;  For call: d, function, params;  for wmem and rmem: choose yourself
+                                    For unary instrs: d (in place) or d, x;  for phi: d, label1, x1, label2, x2...;  for jump: label
+                                    Operands read by an instruction are variables or immediates */
         // if you subclass IRInstr, each IRInstr subclass has its parameters and the previous (very important) comment becomes useless: it would be a better design.
 };
\ No newline at end of file
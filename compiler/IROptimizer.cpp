@@ -1,494 +1,1278 @@
 #include <set>
+#include <unordered_set>
+#include <climits>
+#include <algorithm>
 #include "IROptimizer.h"
+#include "DominatorTree.h"
+#include "Liveness.h"
+#include "LoopNest.h"
+#include "LoopUnroller.h"
+#include "ScalarEvolution.h"
+#include "AvailableCopies.h"
+#include "CopyCoalescer.h"
+#include "SSA.h"
+#include "ValueNumbering.h"
+
+// valeur d'une variable pour la propagation de constantes : pas encore évaluée, constante ou non constante
+struct LatticeValue
+{
+    enum State
+    {
+        undefined,
+        constant,
+        variable
+    } state = undefined;
+    int value = 0;
 
-IROptimizer::IROptimizer(vector<CFG *> *cfgList) : cfgs(cfgList) {}
+    bool operator==(const LatticeValue &other) const
+    {
+        return state == other.state && (state != constant || value == other.value);
+    }
+};
 
-void IROptimizer::optimize() const
+bool IROptimizer::foldOperation(Operation op, const vector<int> &operands, int &result)
 {
-    for (auto cfg : *cfgs)
+    int a = operands[0];
+    int b = operands.size() > 1 ? operands[1] : 0;
+    switch (op)
     {
-        for (auto bb : *cfg->bbs)
-        {
-            deadCodeRemoval(bb);
-            constantVariableOptimization(bb);
-        }
-        unusedVariables(cfg);
+    case ldconst:
+    case copyvar:
+        result = a;
+        return true;
+    case neg:
+        result = (int)(0u - (unsigned)a);
+        return true;
+    case lnot:
+        result = !a;
+        return true;
+    case bwnot:
+        result = ~a;
+        return true;
+    case incr:
+        result = (int)((unsigned)a + 1u);
+        return true;
+    case decr:
+        result = (int)((unsigned)a - 1u);
+        return true;
+    case add:
+        result = (int)((unsigned)a + (unsigned)b);
+        return true;
+    case sub:
+        result = (int)((unsigned)a - (unsigned)b);
+        return true;
+    case mul:
+        result = (int)((unsigned)a * (unsigned)b);
+        return true;
+    case divide:
+    case modulo:
+        if (b == 0 || (a == INT_MIN && b == -1))
+            return false;
+        result = op == divide ? a / b : a % b;
+        return true;
+    case bwor:
+        result = a | b;
+        return true;
+    case bwand:
+        result = a & b;
+        return true;
+    case bwxor:
+        result = a ^ b;
+        return true;
+    case bwsl:
+    case bwsr:
+        if (b < 0 || b > 31)
+            return false;
+        result = op == bwsl ? (int)((unsigned)a << b) : a >> b;
+        return true;
+    case cmp_eq:
+        result = a == b;
+        return true;
+    case cmp_ne:
+        result = a != b;
+        return true;
+    case cmp_lt:
+        result = a < b;
+        return true;
+    case cmp_le:
+        result = a <= b;
+        return true;
+    case cmp_gt:
+        result = a > b;
+        return true;
+    case cmp_ge:
+        result = a >= b;
+        return true;
+    default:
+        return false;
     }
-    replaceJumpInstructions();
-    removeExitWhenReturn();
-    for (auto cfg : *cfgs)
-        do
-            optimizeCFG(cfg);
-        while (simplifyConditionnalBlockJump(cfg));
+}
+
+IROptimizer::IROptimizer(vector<CFG *> *cfgList, int optimizationLevel, chrono::milliseconds passBudget, PassSettings settings) :
+    cfgs(cfgList), passManager(pipeline(optimizationLevel), passBudget, settings) {}
+
+void IROptimizer::optimize()
+{
     for (auto cfg : *cfgs)
-        optimizeCFG(cfg);
+        optimizeFunction(cfg);
+}
+
+void IROptimizer::optimizeFunction(CFG *cfg, ostream *remarks)
+{
+    passManager.run(cfg, remarks);
 }
 
-void IROptimizer::deadCodeRemoval(BasicBlock *bb)
+void IROptimizer::report(ostream &o) const
 {
-    bool hasChanged = true;
-    while (hasChanged)
+    passManager.report(o);
+}
+
+vector<PipelineStep> IROptimizer::pipeline(int optimizationLevel)
+{
+    // les passes obligatoires (true) mettent l'IR dans la forme attendue par gen_asm : sans saut ni retour au milieu d'un bloc
+    static const Pass deadCode = Pass::onBlock("dead-code", deadCodeRemoval, true);
+    static const Pass lowerJumps = Pass::onFunction("lower-jumps", [](CFG *cfg, PassContext &) { return replaceJumpInstructions(cfg); }, false, true);
+    static const Pass lowerReturns = Pass::onFunction("lower-returns", [](CFG *cfg, PassContext &) { return removeExitWhenReturn(cfg); }, false, true);
+    static const Pass foldConstants = Pass::onBlock("fold-constants", constantVariableOptimization);
+    static const Pass dce = Pass::onFunction("dce", deadCodeElimination, true);
+    static const Pass copyPropagationPass = Pass::onFunction("copy-propagation", copyPropagation, true);
+    static const Pass coalesce = Pass::onFunction("coalesce", coalesceCopies, true);
+    static const Pass simplifyCFGPass = Pass::onFunction("simplify-cfg", simplifyCFG, false);
+    static const Pass constantBranches = Pass::onFunction("constant-branches", simplifyConditionnalBlockJump, false);
+    static const Pass threadJumps = Pass::onFunction("thread-jumps", threadConditionalJumps, false);
+    static const Pass ssaBuild = Pass::onFunction("ssa-build", [](CFG *cfg, PassContext &context)
     {
-        hasChanged = false;
-        for (long unsigned i = 0; i + 1 < bb->instrs->size(); i++)
-        {
-            IRInstr *instr1 = (*bb->instrs)[i];
+        context.ssa = make_unique<SSA>(cfg);
+        context.ssa->build(context.dominators());
+        context.changed_all();
+        return 1;
+    }, true);
+    static const Pass sccp = Pass::onFunction("sccp", sparseConditionalConstantPropagation, false);
+    static const Pass gvn = Pass::onFunction("gvn", globalValueNumbering, true);
+    static const Pass licm = Pass::onFunction("licm", loopInvariantCodeMotion, false);
+    static const Pass strengthReduce = Pass::onFunction("strength-reduce", reduceInductionStrength, false);
+    static const Pass exitValues = Pass::onFunction("exit-values", replaceLoopExitValues, false);
+    static const Pass ssaDCE = Pass::onFunction("ssa-dce", ssaDeadCodeElimination, true);
+    static const Pass ssaDestroy = Pass::onFunction("ssa-destroy", [](CFG *, PassContext &context)
+    {
+        if (context.ssa == nullptr)
+            return 0;
+        context.ssa->destroy();
+        context.ssa.reset();
+        context.changed_all();
+        return 1;
+    }, false, true);
+    static const Pass rotate = Pass::onFunction("rotate-loops", rotateLoops, false);
+    static const Pass unroll = Pass::onFunction("unroll-loops", unrollLoops, false);
+    static const Pass layout = Pass::onFunction("layout", layoutBasicBlocks, true);
+
+    vector<PipelineStep> steps = {{{&deadCode}}};
+    if (optimizationLevel >= 1)
+        steps.push_back({{&foldConstants}});
+    if (optimizationLevel >= 1)
+        steps.push_back({{&dce}});
+    steps.push_back({{&lowerJumps}});
+    steps.push_back({{&lowerReturns}});
+    if (optimizationLevel == 0)
+        return steps;
+
+    // la rotation attend des boucles nettoyées (tests des && et || court-circuités), puis ses gardes
+    // d'entrée souvent constantes (for (i = 0; i < 10; ...)) disparaissent au second nettoyage.
+    // Le déroulage attend des boucles tournées et sans copie (a = a + 2 : add t a 2, puis a = t),
+    // le dernier nettoyage enchaîne ses copies et plie ses gardes. simplify-cfg et constant-branches ne revoient que les blocs
+    // modifiés, simplify-cfg plie lui-même les tests devenus constants : la répétition ne rattrape que ce qu'une passe permet à une autre
+    PipelineStep cleanup = {{&simplifyCFGPass, &foldConstants, &constantBranches, &threadJumps}, true};
+    // une boucle interne remplacée par ses valeurs de sortie laisse des calculs invariants dans la boucle
+    // qui la contenait : sortis, celle-ci peut être remplacée à son tour
+    PipelineStep closedForms = {{&strengthReduce, &exitValues, &licm}, true};
+    steps.push_back(cleanup);
+    steps.push_back({{&rotate}});
+    steps.push_back(cleanup);
+    if (optimizationLevel >= 2)
+    {
+        // une boucle qui ne calcule que des valeurs lues après elle est remplacée avant d'être déroulée :
+        // sinon la boucle déroulée et la boucle de reste le seraient chacune
+        steps.push_back({{&ssaBuild}});
+        steps.push_back({{&licm}});
+        steps.push_back(closedForms);
+        steps.push_back({{&ssaDCE}});
+        steps.push_back({{&ssaDestroy}});
+        steps.push_back(cleanup);
+    }
+    steps.push_back({{&copyPropagationPass}});
+    steps.push_back({{&dce}});
+    steps.push_back({{&coalesce}});
+    steps.push_back({{&unroll}});
+    steps.push_back(cleanup);
+    steps.push_back({{&dce}});
+    if (optimizationLevel >= 2)
+    {
+        steps.push_back({{&ssaBuild}});
+        steps.push_back({{&sccp}});
+        steps.push_back({{&gvn}});
+        steps.push_back({{&licm}});
+        steps.push_back(closedForms);
+        steps.push_back({{&ssaDCE}});
+        steps.push_back({{&ssaDestroy}});
+        steps.push_back({{&simplifyCFGPass}});
+        steps.push_back({{&foldConstants}});
+    }
+    steps.push_back({{&layout}});
+    return steps;
+}
 
-            if ((instr1->op == jump or instr1->op == ret or instr1->op == ret_cst))
-            {
-                bb->instrs->erase(bb->instrs->begin() + i + 1, bb->instrs->begin() + i + 2);
-                hasChanged = true;
-            }
+int IROptimizer::deadCodeRemoval(BasicBlock *bb)
+{
+    // tout ce qui suit un saut ou un retour dans le bloc
+    for (long unsigned i = 0; i + 1 < bb->instrs->size(); i++)
+    {
+        IRInstr *instr = (*bb->instrs)[i];
+        if (instr->op == jump || instr->op == ret || instr->op == ret_cst)
+        {
+            int removed = bb->instrs->size() - i - 1;
+            bb->instrs->erase(bb->instrs->begin() + i + 1, bb->instrs->end());
+            return removed;
         }
     }
+    return 0;
 }
 
-void IROptimizer::optimizeCFG(CFG *cfg)
+int IROptimizer::constantVariableOptimization(BasicBlock *bb)
 {
-    bypassEmptyIntermediateBlocks(cfg);
-    removeUnusedBasicBlocks(cfg);
-    mergeBasicBlocks(cfg);
-    for (auto bb : *cfg->bbs)
-        constantVariableOptimization(bb);
+    map<int, int> constVars;
+    return foldConstantsFrom(bb, 0, constVars);
 }
 
-void IROptimizer::constantVariableOptimization(BasicBlock *bb)
+int IROptimizer::foldConstantsFrom(BasicBlock *bb, unsigned long from, map<int, int> &constVars)
 {
-    auto *constVars = new map<string, string>;
+    int changes = 0;
     // map des ldconst
-    // K: variable index, V: <value, index in instrs vector>
+    // K: variable index, V: valeur connue à ce point du bloc
 
-    for (long unsigned i = 0; i < bb->instrs->size(); i++)
+    for (long unsigned i = from; i < bb->instrs->size(); i++)
     {
         IRInstr *instr = (*bb->instrs)[i];
+        int defined = instr->get_defined_var();
 
-        switch (instr->op)
+        if (instr->op == ldconst)
         {
-        case ldconst:
-            if (constVars->find(instr->params[0]) == constVars->end())
+            // mémorisation d'un ldconst
+            constVars[defined] = instr->params[1].get_value();
+            continue;
+        }
+
+        // les variables de valeur connue deviennent des opérandes immédiats
+        vector<int> operands;
+        bool allConstants = true;
+        for (unsigned long index : instr->get_source_indices())
+        {
+            Operand &operand = instr->params[index];
+            auto constant = operand.is_variable() ? constVars.find(operand.get_index()) : constVars.end();
+            if (constant != constVars.end())
             {
-                // mémorisation d'un ldconst
-                constVars->insert({instr->params[0], instr->params[1]});
+                operands.push_back(constant->second);
+                // une instruction unaire en place lit et écrit P0 : on ne peut que la simplifier
+                if (index != 0 || defined == 0)
+                {
+                    operand = Operand::immediate(constant->second);
+                    changes++;
+                }
             }
+            else if (operand.is_immediate())
+                operands.push_back(operand.get_value());
             else
-            {
-                (*constVars)[instr->params[0]] = instr->params[1];
-            }
-            break;
+                allConstants = false;
+        }
 
-        case copyvar:
-            if (constVars->find(instr->params[1]) != constVars->end())
-            {
-                auto *newInstr = new IRInstr(bb, ldconst, {instr->params[0], (*constVars)[instr->params[1]]});
+        if (defined == 0)
+            continue;
+        int value;
+        if (allConstants && instr->op != call && instr->op != phi && foldOperation(instr->op, operands, value))
+            changes += reduce(bb, i, value, instr, &constVars);
+        else
+            // résultat inconnu
+            constVars.erase(defined);
+    }
+    return changes;
+}
 
-                bb->instrs->erase(bb->instrs->begin() + i, bb->instrs->begin() + i + 1);
-                bb->instrs->insert(bb->instrs->begin() + i, newInstr);
+int IROptimizer::deadCodeElimination(CFG *cfg, PassContext &context)
+{
+    // vivacité forte : une instruction dont le résultat n'est jamais lu ne rend pas ses opérandes vivants,
+    // les chaînes et les cycles de calculs inutiles disparaissent en un seul passage
+    Liveness liveness(cfg, true, [&context]() { return context.out_of_time(); });
+    if (!liveness.is_solved())
+        return 0;
+    int removed = 0;
+    for (BasicBlock *bb : *cfg->bbs)
+    {
+        BitVector live = liveness.live_after_instructions(bb);
+        unsigned long kept = bb->instrs->size();
+        for (unsigned long i = bb->instrs->size(); i-- > 0;)
+        {
+            IRInstr *instr = (*bb->instrs)[i];
+            if (!liveness.is_useful(instr, live))
+                continue;
+            liveness.step(instr, live);
+            (*bb->instrs)[--kept] = instr;
+        }
+        if (kept == 0)
+            continue;
+        // les instructions gardées ont été tassées à la fin du bloc
+        bb->instrs->erase(bb->instrs->begin(), bb->instrs->begin() + kept);
+        removed += kept;
+        context.changed(bb);
+    }
+    return removed;
+}
 
-                (*constVars)[instr->params[0]] = (*constVars)[instr->params[1]];
+int IROptimizer::copyPropagation(CFG *cfg, PassContext &context)
+{
+    AvailableCopies copies(cfg);
+    int replaced = 0;
+    for (BasicBlock *bb : *cfg->bbs)
+    {
+        AvailableCopies::Walk walk(copies, bb);
+        bool changed = false;
+        for (IRInstr *instr : *bb->instrs)
+        {
+            int defined = instr->get_defined_var();
+            for (unsigned long i : instr->get_source_indices())
+            {
+                // la forme en place (neg P0) lit et écrit le même opérande
+                if (!instr->params[i].is_variable() || (i == 0 && defined != 0))
+                    continue;
+                int source = walk.find_source(instr->params[i].get_index());
+                if (source == 0)
+                    continue;
+                instr->params[i] = Operand::variable(source);
+                replaced++;
+                changed = true;
             }
-            break;
-
-        case lnot:
-            if (constVars->find(instr->params[0]) != constVars->end())
-                reduce(bb, i, !stoi((*constVars)[instr->params[0]]), instr, constVars);
-            break;
-
-        case neg:
-            if (constVars->find(instr->params[0]) != constVars->end())
-                reduce(bb, i, -stoi((*constVars)[instr->params[0]]), instr, constVars);
-            break;
-
-        case incr:
-            if (constVars->find(instr->params[0]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[0]]) + 1, instr, constVars);
-            break;
-
-        case decr:
-            if (constVars->find(instr->params[0]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[0]]) - 1, instr, constVars);
-            break;
-
-        case bwnot:
-            if (constVars->find(instr->params[0]) != constVars->end())
-                reduce(bb, i, ~stoi((*constVars)[instr->params[0]]), instr, constVars);
-            break;
-
-        case add:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) + stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case mul:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) * stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case sub:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) - stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case divide:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end() and stoi((*constVars)[instr->params[2]]) != 0)
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) / stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case modulo:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end() and stoi((*constVars)[instr->params[2]]) != 0)
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) % stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case bwand:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) & stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case bwor:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) | stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case bwxor:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) ^ stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case cmp_eq:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) == stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-            break;
-
-        case cmp_lt:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) < stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-            break;
-
-        case cmp_le:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) <= stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-            break;
-
-        case cmp_ge:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) >= stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-
-            break;
-
-        case cmp_gt:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) > stoi((*constVars)[instr->params[2]]), instr, constVars);
-
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
+            walk.step(instr);
+        }
+        if (bb->exit_false != nullptr)
+        {
+            int source = walk.find_source(bb->test_var_index);
+            if (source != 0)
+            {
+                bb->test_var_index = source;
+                replaced++;
+                changed = true;
+            }
+        }
+        if (changed)
+            context.changed(bb);
+    }
+    return replaced;
+}
 
-            break;
+int IROptimizer::coalesceCopies(CFG *cfg, PassContext &context)
+{
+    vector<IRInstr *> copies;
+    for (BasicBlock *bb : *cfg->bbs)
+        for (IRInstr *instr : *bb->instrs)
+            if (instr->op == copyvar && instr->params[1].is_variable())
+                copies.push_back(instr);
+    int removed = CopyCoalescer(cfg).coalesce(copies);
+    if (removed != 0)
+        context.changed_all();
+    return removed;
+}
 
-        case cmp_ne:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) != stoi((*constVars)[instr->params[2]]), instr, constVars);
+int IROptimizer::sparseConditionalConstantPropagation(CFG *cfg, PassContext &context)
+{
+    if (context.ssa == nullptr)
+        return 0;
+    // algorithme de Wegman et Zadeck : on propage les constantes le long des arcs exécutables
+    // et le long des chaînes définition-utilisations de la forme SSA
+    map<int, LatticeValue> values;
+    map<int, vector<IRInstr *>> users;
+    map<int, vector<BasicBlock *>> testingBlocks;
+    map<IRInstr *, BasicBlock *> blockOf;
+    for (auto bb : *cfg->bbs)
+    {
+        for (auto instr : *bb->instrs)
+        {
+            blockOf[instr] = bb;
+            for (int var : instr->get_used_vars())
+                users[var].push_back(instr);
+        }
+        if (bb->exit_false != nullptr)
+            testingBlocks[bb->test_var_index].push_back(bb);
+    }
 
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
+    // les variables sans définition (paramètres, variables non initialisées) ne sont pas constantes
+    auto valueOf = [&values](const Operand &operand)
+    {
+        if (operand.is_immediate())
+            return LatticeValue{LatticeValue::constant, operand.get_value()};
+        auto it = values.find(operand.get_index());
+        if (it != values.end())
+            return it->second;
+        return LatticeValue{LatticeValue::variable, 0};
+    };
+    for (auto bb : *cfg->bbs)
+        for (auto instr : *bb->instrs)
+        {
+            int defined = instr->get_defined_var();
+            if (defined != 0)
+                values[defined] = LatticeValue();
+        }
 
-            break;
+    set<BasicBlock *> executableBlocks;
+    set<pair<BasicBlock *, BasicBlock *>> executableEdges;
+    vector<pair<BasicBlock *, BasicBlock *>> edgeWorklist = {{nullptr, cfg->bbs->front()}};
+    vector<IRInstr *> instrWorklist;
+    vector<BasicBlock *> branchWorklist;
 
-        case bwsl:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) << stoi((*constVars)[instr->params[2]]), instr, constVars);
+    auto evaluate = [&](IRInstr *instr)
+    {
+        int defined = instr->get_defined_var();
+        if (defined == 0)
+            return;
 
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-            break;
+        LatticeValue result;
+        if (instr->op == phi)
+        {
+            // rencontre des valeurs arrivant par les arcs exécutables
+            for (unsigned long i = 1; i < instr->params.size(); i += 2)
+            {
+                if (executableEdges.count({instr->params[i].get_block(), blockOf[instr]}) == 0)
+                    continue;
+                LatticeValue operand = valueOf(instr->params[i + 1]);
+                if (operand.state == LatticeValue::undefined)
+                    continue;
+                if (result.state == LatticeValue::undefined)
+                    result = operand;
+                else if (!(result == operand))
+                    result.state = LatticeValue::variable;
+            }
+        }
+        else if (instr->op == ldconst)
+            result = {LatticeValue::constant, instr->params[1].get_value()};
+        else if (instr->op == call)
+            result.state = LatticeValue::variable;
+        else
+        {
+            // non constant dès qu'un opérande ne l'est pas, indéfini tant qu'un opérande n'est pas évalué
+            vector<int> operands;
+            bool undefinedOperand = false;
+            result.state = LatticeValue::constant;
+            for (unsigned long index : instr->get_source_indices())
+            {
+                LatticeValue operand = valueOf(instr->params[index]);
+                if (operand.state == LatticeValue::variable)
+                {
+                    result.state = LatticeValue::variable;
+                    break;
+                }
+                undefinedOperand = undefinedOperand || operand.state == LatticeValue::undefined;
+                operands.push_back(operand.value);
+            }
+            if (result.state == LatticeValue::constant && undefinedOperand)
+                result.state = LatticeValue::undefined;
+            else if (result.state == LatticeValue::constant && !foldOperation(instr->op, operands, result.value))
+                result.state = LatticeValue::variable;
+        }
 
-        case bwsr:
-            if ((constVars->find(instr->params[1]) != constVars->end()) and constVars->find(instr->params[2]) != constVars->end())
-                reduce(bb, i, stoi((*constVars)[instr->params[1]]) >> stoi((*constVars)[instr->params[2]]), instr, constVars);
+        // les valeurs ne peuvent que descendre dans le treillis
+        LatticeValue &current = values[defined];
+        if (result == current)
+            return;
+        if (current.state != LatticeValue::undefined)
+            result.state = LatticeValue::variable;
+        current = result;
+        for (auto user : users[defined])
+            if (executableBlocks.count(blockOf[user]) != 0)
+                instrWorklist.push_back(user);
+        for (auto bb : testingBlocks[defined])
+            if (executableBlocks.count(bb) != 0)
+                branchWorklist.push_back(bb);
+    };
+
+    auto visitBranch = [&](BasicBlock *bb)
+    {
+        if (bb->exit_false == nullptr)
+        {
+            if (bb->exit_true != nullptr)
+                edgeWorklist.emplace_back(bb, bb->exit_true);
+            return;
+        }
+        LatticeValue test = valueOf(Operand::variable(bb->test_var_index));
+        if (test.state == LatticeValue::undefined)
+            return;
+        if (test.state == LatticeValue::variable || test.value != 0)
+            edgeWorklist.emplace_back(bb, bb->exit_true);
+        if (test.state == LatticeValue::variable || test.value == 0)
+            edgeWorklist.emplace_back(bb, bb->exit_false);
+    };
+
+    while (!edgeWorklist.empty() || !instrWorklist.empty() || !branchWorklist.empty())
+    {
+        if (!edgeWorklist.empty())
+        {
+            auto edge = edgeWorklist.back();
+            edgeWorklist.pop_back();
+            if (!executableEdges.insert(edge).second)
+                continue;
+            BasicBlock *bb = edge.second;
+            if (!executableBlocks.insert(bb).second)
+            {
+                // nouvel arc vers un bloc déjà visité : seuls ses phi changent
+                for (auto instr : *bb->instrs)
+                    if (instr->op == phi)
+                        evaluate(instr);
+                continue;
+            }
+            for (auto instr : *bb->instrs)
+                evaluate(instr);
+            visitBranch(bb);
+        }
+        else if (!instrWorklist.empty())
+        {
+            IRInstr *instr = instrWorklist.back();
+            instrWorklist.pop_back();
+            evaluate(instr);
+        }
+        else
+        {
+            BasicBlock *bb = branchWorklist.back();
+            branchWorklist.pop_back();
+            visitBranch(bb);
+        }
+    }
 
-            else if (constVars->find(instr->params[0]) != constVars->end())
-                constVars->erase(instr->params[0]);
-            break;
+    // réécriture : branchements constants, blocs inatteignables et variables constantes
+    int changes = 0;
+    vector<BasicBlock *> reachable;
+    for (auto bb : *cfg->bbs)
+    {
+        if (executableBlocks.count(bb) == 0)
+        {
+            bb->detach();
+            changes++;
+            continue;
+        }
+        reachable.push_back(bb);
+        if (bb->exit_false != nullptr)
+        {
+            LatticeValue test = valueOf(Operand::variable(bb->test_var_index));
+            if (test.state == LatticeValue::constant)
+            {
+                if (test.value == 0)
+                    bb->set_exit_true(bb->exit_false);
+                bb->set_exit_false(nullptr);
+                changes++;
+            }
+        }
 
-        case jump:
-        case call:
-        case rmem:
-        case wmem:
-        case ret:
-        case ret_cst:
-            // opérateurs non simplifiables
-            break;
+        vector<IRInstr *> phis;
+        vector<IRInstr *> others;
+        for (auto instr : *bb->instrs)
+        {
+            if (instr->op == phi)
+            {
+                // on retire les opérandes venant d'arcs jamais exécutés
+                vector<Operand> params = {instr->params[0]};
+                for (unsigned long i = 1; i < instr->params.size(); i += 2)
+                    if (executableEdges.count({instr->params[i].get_block(), bb}) != 0)
+                    {
+                        params.push_back(instr->params[i]);
+                        params.push_back(instr->params[i + 1]);
+                    }
+                instr->params.assign(params.begin(), params.end());
+            }
+            int defined = instr->get_defined_var();
+            LatticeValue value = instr->op == call || defined == 0 ? LatticeValue() : valueOf(Operand::variable(defined));
+            if (value.state == LatticeValue::constant && instr->op != ldconst)
+            {
+                instr = cfg->create_instr(bb, ldconst, {instr->params[0], Operand::immediate(value.value)});
+                changes++;
+            }
+            else
+                // les variables constantes lues deviennent des opérandes immédiats
+                for (unsigned long index : instr->get_source_indices())
+                {
+                    LatticeValue operand = valueOf(instr->params[index]);
+                    if (operand.state == LatticeValue::constant && !instr->params[index].is_immediate() && (index != 0 || defined == 0))
+                    {
+                        instr->params[index] = Operand::immediate(operand.value);
+                        changes++;
+                    }
+                }
+            (instr->op == phi ? phis : others).push_back(instr);
         }
+        bb->instrs->assign(phis.begin(), phis.end());
+        bb->instrs->insert(bb->instrs->end(), others.begin(), others.end());
     }
+    cfg->bbs->assign(reachable.begin(), reachable.end());
+    if (changes != 0)
+        context.changed_all();
+    return changes;
 }
 
-void IROptimizer::unusedVariables(CFG *cfg)
+int IROptimizer::globalValueNumbering(CFG *cfg, PassContext &context)
 {
-    bool instructionRemoved = true;
+    if (context.ssa == nullptr)
+        return 0;
+    int removed = ValueNumbering(cfg).eliminate(context.dominators());
+    if (removed != 0)
+        context.changed_all();
+    return removed;
+}
 
-    while (instructionRemoved)
+int IROptimizer::loopInvariantCodeMotion(CFG *cfg, PassContext &context)
+{
+    if (context.ssa == nullptr)
+        return 0;
+    LoopNest loops(cfg, context.dominators());
+    if (loops.get_loops().empty())
+        return 0;
+    int changes = loops.create_preheaders();
+
+    map<int, BasicBlock *> definitionBlocks;
+    for (auto bb : *cfg->bbs)
+        for (auto instr : *bb->instrs)
+            if (instr->get_defined_var() != 0)
+                definitionBlocks[instr->get_defined_var()] = bb;
+
+    // en SSA, une instruction dont les opérandes sont définis hors de la boucle (ou par des instructions
+    // déjà sorties) calcule la même valeur à chaque tour : on la calcule une fois, dans le préen-tête.
+    // Elle y est exécutée même quand la boucle ne fait aucun tour : seules les instructions sans effet
+    // de bord ni erreur possible sortent (pas d'appel, pas de division par un diviseur inconnu).
+    // Les boucles internes d'abord : ce qui sort d'une boucle peut encore sortir de la boucle qui la contient.
+    for (Loop *loop : loops.get_loops())
     {
-        instructionRemoved = false;
-        set<string> usedVariables;
-
-        // trouver les variables utilisées
-        for (BasicBlock *bb : *cfg->bbs)
+        BasicBlock *preheader = loop->preheader;
+        for (auto bb : loop->blocks)
         {
-
-            if (bb->exit_false != nullptr)
-                usedVariables.insert(to_string(bb->test_var_index));
-
+            vector<IRInstr *> kept;
             for (auto instr : *bb->instrs)
             {
-
+                bool invariant;
                 switch (instr->op)
                 {
-                case lnot:
-                case bwnot:
-                case incr:
-                case decr:
-                case neg:
+                case call:
+                case phi:
                 case jump:
-                case ldconst:
+                case ret:
+                case ret_cst:
                 case rmem:
                 case wmem:
-                case ret_cst:
-                    break;
-
-                case call:
-                    for (const string &param : instr->params)
-                    {
-                        usedVariables.insert(param);
-                    }
-                    break;
-
-                case ret:
-                    usedVariables.insert(instr->params[0]);
+                    invariant = false;
                     break;
-
-                case add:
-                case sub:
-                case mul:
                 case divide:
                 case modulo:
-                case bwor:
-                case bwand:
-                case bwxor:
-                case cmp_eq:
-                case cmp_lt:
-                case cmp_le:
-                case cmp_ge:
-                case cmp_gt:
-                case cmp_ne:
-                case bwsl:
-                case bwsr:
-                    usedVariables.insert(instr->params[2]);
-                case copyvar:
-                    usedVariables.insert(instr->params[1]);
+                    invariant = instr->params[2].is_immediate() && instr->params[2].get_value() != 0 && instr->params[2].get_value() != -1;
                     break;
+                default:
+                    invariant = true;
+                }
+                for (int var : instr->get_used_vars())
+                {
+                    auto definition = definitionBlocks.find(var);
+                    if (definition != definitionBlocks.end() && loop->contains(definition->second))
+                        invariant = false;
                 }
+                if (!invariant)
+                {
+                    kept.push_back(instr);
+                    continue;
+                }
+                preheader->instrs->push_back(instr);
+                definitionBlocks[instr->get_defined_var()] = preheader;
+                changes++;
             }
+            bb->instrs->assign(kept.begin(), kept.end());
         }
+    }
+    if (changes != 0)
+        context.changed_all();
+    return changes;
+}
 
-        // enlever les variables inutilisées
-        for (BasicBlock *bb : *cfg->bbs)
-            for (long unsigned i = 0; i < bb->instrs->size(); i++)
-            {
-                IRInstr *instr = (*bb->instrs)[i];
+int IROptimizer::reduceInductionStrength(CFG *cfg, PassContext &context)
+{
+    // i * y (y invariant) croît de pas * y à chaque tour : une addition par tour au lieu d'un produit
+    if (context.ssa == nullptr)
+        return 0;
+    LoopNest loops(cfg, context.dominators());
+    if (loops.get_loops().empty())
+        return 0;
+    int changes = loops.create_preheaders();
+    // les lectures de chaque variable, cherchées une fois pour toutes les boucles : un produit remplacé par q
+    // ne fait pas parcourir toute la fonction
+    ScalarEvolution::UseIndex index(cfg);
+    for (Loop *loop : loops.get_loops())
+    {
+        if (context.out_of_time())
+            break;
+        changes += ScalarEvolution(cfg, loop).reduceStrength(index);
+    }
+    if (changes != 0)
+        context.changed_all();
+    return changes;
+}
 
-                switch (instr->op)
-                {
-                case call:
-                case jump:
-                case ret:
-                    break;
-                default:
-                    if (usedVariables.find(instr->params[0]) == usedVariables.end())
-                    {
-                        bb->instrs->erase(bb->instrs->begin() + i, bb->instrs->begin() + i + 1);
-                        instructionRemoved = true;
-                    }
-                }
-            }
+int IROptimizer::replaceLoopExitValues(CFG *cfg, PassContext &context)
+{
+    // une boucle sans effet de bord dont le nombre de tours se calcule ne sert qu'aux valeurs lues après elle :
+    // calculées directement, la boucle disparaît. Les boucles les plus internes seulement, la boucle qui les
+    // contenait est examinée au tour suivant
+    if (context.ssa == nullptr)
+        return 0;
+    LoopNest loops(cfg, context.dominators());
+    if (loops.get_loops().empty())
+        return 0;
+    int changes = loops.create_preheaders();
+    // les lectures de chaque variable, cherchées une fois pour toutes les boucles ; les blocs des boucles
+    // supprimées sont retirés ensemble à la fin
+    ScalarEvolution::UseIndex index(cfg);
+    for (Loop *loop : loops.get_loops())
+    {
+        if (context.out_of_time())
+            break;
+        if (!loop->children.empty())
+            continue;
+        string label = loop->header->label;
+        if (!ScalarEvolution(cfg, loop).replaceExitValues(index))
+            continue;
+        if (context.remarks != nullptr)
+            *context.remarks << "remark: " << cfg->cfg_name << ": loop " << label << ": replaced by the values it computes\n";
+        changes++;
     }
+    if (!index.removed.empty())
+        cfg->bbs->erase(remove_if(cfg->bbs->begin(), cfg->bbs->end(), [&index](BasicBlock *bb)
+                                  { return index.removed.count(bb) != 0; }),
+                        cfg->bbs->end());
+    if (changes != 0)
+        context.changed_all();
+    return changes;
 }
 
-bool IROptimizer::simplifyConditionnalBlockJump(CFG *cfg)
+int IROptimizer::ssaDeadCodeElimination(CFG *cfg, PassContext &context)
 {
-    bool changed = false;
+    if (context.ssa == nullptr)
+        return 0;
+    // en SSA chaque variable a une seule définition : on marque les instructions utiles
+    // à partir des effets de bord (appels, retours) et des tests de fin de bloc
+    map<int, IRInstr *> definitions;
+    set<IRInstr *> useful;
+    vector<IRInstr *> worklist;
+    vector<int> usedVariables;
     for (auto bb : *cfg->bbs)
+    {
+        for (auto instr : *bb->instrs)
+        {
+            int defined = instr->get_defined_var();
+            if (defined != 0)
+                definitions[defined] = instr;
+            switch (instr->op)
+            {
+            case call:
+            case jump:
+            case ret:
+            case ret_cst:
+            case wmem:
+                useful.insert(instr);
+                worklist.push_back(instr);
+                break;
+            default:
+                break;
+            }
+        }
         if (bb->exit_false != nullptr)
+            usedVariables.push_back(bb->test_var_index);
+    }
+
+    while (!worklist.empty() || !usedVariables.empty())
+    {
+        if (!worklist.empty())
+        {
+            IRInstr *instr = worklist.back();
+            worklist.pop_back();
+            for (int var : instr->get_used_vars())
+                usedVariables.push_back(var);
+            continue;
+        }
+        auto definition = definitions.find(usedVariables.back());
+        usedVariables.pop_back();
+        // les valeurs d'entrée (paramètres) n'ont pas de définition
+        if (definition != definitions.end() && useful.insert(definition->second).second)
+            worklist.push_back(definition->second);
+    }
+
+    // chaque bloc est tassé en un seul passage
+    int removed = 0;
+    for (auto bb : *cfg->bbs)
+    {
+        auto end = remove_if(bb->instrs->begin(), bb->instrs->end(), [&useful](IRInstr *instr)
+                             { return useful.find(instr) == useful.end(); });
+        if (end == bb->instrs->end())
+            continue;
+        removed += bb->instrs->end() - end;
+        bb->instrs->erase(end, bb->instrs->end());
+        context.changed(bb);
+    }
+    return removed;
+}
+
+int IROptimizer::simplifyConditionnalBlockJump(CFG *, PassContext &context)
+{
+    int changed = 0;
+    for (auto bb : context.changed_blocks())
+    {
+        BasicBlock *dropped = foldConstantBranch(bb);
+        if (dropped == nullptr)
+            continue;
+        // dropped a perdu un prédécesseur : simplify-cfg le retire ou le fusionne
+        context.changed(bb);
+        context.changed(dropped);
+        changed++;
+    }
+    return changed;
+}
+
+BasicBlock *IROptimizer::foldConstantBranch(BasicBlock *bb)
+{
+    if (bb->exit_false == nullptr)
+        return nullptr;
+    // seule la dernière écriture de la variable testée compte
+    for (auto it = bb->instrs->rbegin(); it != bb->instrs->rend(); it++)
+        if ((*it)->get_defined_var() == bb->test_var_index)
+        {
+            if ((*it)->op != ldconst)
+                return nullptr;
+            BasicBlock *dropped = bb->exit_true;
+            if ((*it)->params[1].get_value() == 0)
+                bb->set_exit_true(bb->exit_false);
+            else
+                dropped = bb->exit_false;
+            bb->set_exit_false(nullptr);
+            return dropped;
+        }
+    return nullptr;
+}
+
+int IROptimizer::threadConditionalJumps(CFG *cfg, PassContext &context)
+{
+    // un bloc vide qui ne fait que tester une variable (sortie d'un && ou d'un ||) :
+    // un prédécesseur qui connaît la valeur de cette variable saute directement à la bonne sortie
+
+    // valeur constante de var à la fin de bb, en remontant les prédécesseurs uniques
+    auto constantAtEnd = [](BasicBlock *bb, int var, int &value)
+    {
+        set<BasicBlock *> visited;
+        while (visited.insert(bb).second)
+        {
             for (auto it = bb->instrs->rbegin(); it != bb->instrs->rend(); it++)
-                if ((*it)->op == ldconst && stoi((*it)->params[0]) == bb->test_var_index)
+                if ((*it)->get_defined_var() == var)
                 {
-                    changed = true;
-                    if (stoi((*it)->params[1]) == 0)
-                        bb->exit_true = bb->exit_false;
-                    bb->exit_false = nullptr;
-                    break;
+                    if ((*it)->op != ldconst)
+                        return false;
+                    value = (*it)->params[1].get_value();
+                    return true;
                 }
+            if (bb->predecessors->size() != 1)
+                return false;
+            bb = bb->predecessors->front();
+        }
+        return false;
+    };
+
+    int changed = 0;
+    for (auto target : *cfg->bbs)
+    {
+        if (target->exit_false == nullptr || !target->instrs->empty())
+            continue;
+        int var = target->test_var_index;
+        // copie : les prédécesseurs de target changent à chaque saut redirigé
+        vector<BasicBlock *> preds(target->predecessors->begin(), target->predecessors->end());
+        for (auto pred : preds)
+        {
+            // un test dont les deux sorties menaient à target a déjà été redirigé
+            if (pred->exit_true != target && pred->exit_false != target)
+                continue;
+            int value;
+            if (!constantAtEnd(pred, var, value))
+                continue;
+            BasicBlock *dest = value != 0 ? target->exit_true : target->exit_false;
+            if (dest == target)
+                continue;
+            if (pred->exit_true == target)
+                pred->set_exit_true(dest);
+            if (pred->exit_false == target)
+                pred->set_exit_false(dest);
+            context.changed(pred);
+            context.changed(target);
+            changed++;
+        }
+    }
     return changed;
 }
 
-bool IROptimizer::reduce(BasicBlock *bb, int index, int value, IRInstr *instr, map<string, string> *constVars)
+bool IROptimizer::reduce(BasicBlock *bb, int index, int value, IRInstr *instr, map<int, int> *constVars)
 {
-    auto *newInstr = new IRInstr(bb, ldconst, {(*bb->instrs)[index]->params[0], to_string(value)});
+    auto *newInstr = bb->cfg->create_instr(bb, ldconst, {(*bb->instrs)[index]->params[0], Operand::immediate(value)});
 
     bb->instrs->erase(bb->instrs->begin() + index, bb->instrs->begin() + index + 1);
     bb->instrs->insert(bb->instrs->begin() + index, newInstr);
 
-    (*constVars)[instr->params[0]] = to_string(value);
+    (*constVars)[instr->params[0].get_index()] = value;
 
     return true;
 }
 
-void IROptimizer::replaceJumpInstructions() const
+int IROptimizer::replaceJumpInstructions(CFG *cfg)
 {
-    for (auto cfg : *cfgs)
-        for (auto bb : *cfg->bbs)
-            if (!bb->instrs->empty() && bb->instrs->back()->op == jump)
-            {
-                string bb_label = bb->instrs->back()->params.at(0);
-                bb->exit_false = nullptr;
-                bb->exit_true = cfg->find_bb_by_name(bb_label);
-                bb->instrs->pop_back();
-            }
+    int replaced = 0;
+    for (auto bb : *cfg->bbs)
+        if (!bb->instrs->empty() && bb->instrs->back()->op == jump)
+        {
+            bb->set_exit_false(nullptr);
+            bb->set_exit_true(bb->instrs->back()->params.at(0).get_block());
+            bb->instrs->pop_back();
+            replaced++;
+        }
+    return replaced;
 }
 
-void IROptimizer::removeExitWhenReturn() const
+int IROptimizer::removeExitWhenReturn(CFG *cfg)
 {
-    for (auto cfg : *cfgs)
-        for (auto bb : *cfg->bbs)
-            if (!bb->instrs->empty() && (bb->instrs->back()->op == ret || bb->instrs->back()->op == ret_cst))
-            {
-                bb->exit_false = nullptr;
-                bb->exit_true = nullptr;
-            }
+    int removed = 0;
+    for (auto bb : *cfg->bbs)
+        if (!bb->instrs->empty() && (bb->instrs->back()->op == ret || bb->instrs->back()->op == ret_cst)
+            && (bb->exit_true != nullptr || bb->exit_false != nullptr))
+        {
+            bb->set_exit_false(nullptr);
+            bb->set_exit_true(nullptr);
+            removed++;
+        }
+    return removed;
 }
 
-void IROptimizer::mergeBasicBlocks(CFG *cfg)
+int IROptimizer::rotateLoops(CFG *cfg, PassContext &context)
 {
-    map<BasicBlock *, int> callsByBB;
+    // while (c) corps devient if (c) do corps while (c) : le test de l'en-tête est recopié à la fin de la boucle,
+    // l'en-tête ne sert plus que de garde à l'entrée. Un tour ne coûte plus qu'un branchement conditionnel.
+    // Recopier un bloc ne change pas le sens du programme ; les boucles externes d'abord : la copie de
+    // leur en-tête n'appartient à aucune des boucles qu'elles contiennent, dont les blocs restent valides
+    LoopNest loops(cfg, context.dominators());
+    if (loops.get_loops().empty())
+        return 0;
+
+    // bloc qui lit chaque variable, nullptr si plusieurs le font
+    unordered_map<int, BasicBlock *> readers;
+    auto read = [&readers](int var, BasicBlock *bb)
+    {
+        auto it = readers.emplace(var, bb).first;
+        if (it->second != bb)
+            it->second = nullptr;
+    };
     for (auto bb : *cfg->bbs)
     {
-        if (bb->exit_true != nullptr)
-            callsByBB[bb->exit_true] += 1;
+        for (auto instr : *bb->instrs)
+            for (int var : instr->get_used_vars())
+                read(var, bb);
         if (bb->exit_false != nullptr)
-            callsByBB[bb->exit_false] += 1;
+            read(bb->test_var_index, bb);
     }
-    for (long unsigned i = 0; i < cfg->bbs->size(); i++)
+
+    int rotated = 0;
+    const vector<Loop *> &all = loops.get_loops();
+    for (auto it = all.rbegin(); it != all.rend(); it++)
     {
-        BasicBlock *bb = (*cfg->bbs)[i];
-        if (callsByBB[bb->exit_true] == 1 && bb->exit_false == nullptr)
+        Loop *loop = *it;
+        BasicBlock *header = loop->header;
+        if (header->exit_false == nullptr || header->instrs->size() > maxRotatedTest)
+            continue;
+        // une seule des deux sorties quitte la boucle (sinon la boucle a déjà son test en bas)
+        if (loop->contains(header->exit_true) == loop->contains(header->exit_false))
+            continue;
+        vector<BasicBlock *> latches;
+        bool entered = false;
+        for (auto pred : *header->predecessors)
+        {
+            if (!loop->contains(pred))
+                entered = true;
+            else if (find(latches.begin(), latches.end(), pred) == latches.end())
+                latches.push_back(pred);
+        }
+        if (!entered || find(latches.begin(), latches.end(), header) != latches.end())
+            continue;
+
+        // les temporaires du test, écrits puis lus seulement dans l'en-tête, ont leur propre copie :
+        // chaque comparaison reste lue par le seul branchement de son bloc (voir BasicBlock::gen_asm)
+        auto test = cfg->create_bb(cfg->new_BB_name("loop_test"));
+        unordered_set<int> readFirst;
+        unordered_map<int, int> renamed;
+        for (auto instr : *header->instrs)
         {
-            for (auto instr : *bb->exit_true->instrs)
-                bb->instrs->push_back(instr);
-            for (auto it = cfg->bbs->begin(); it != cfg->bbs->end(); it++)
-                if (*it == bb->exit_true)
+            vector<Operand> params(instr->params.begin(), instr->params.end());
+            for (unsigned long i : instr->get_source_indices())
+                if (params[i].is_variable())
                 {
-                    cfg->bbs->erase(it);
-                    break;
+                    int var = params[i].get_index();
+                    if (renamed.count(var) != 0)
+                        params[i] = Operand::variable(renamed[var]);
+                    else
+                        readFirst.insert(var);
                 }
-            bb->test_var_index = bb->exit_true->test_var_index;
-            bb->exit_false = bb->exit_true->exit_false;
-            bb->exit_true = bb->exit_true->exit_true;
-            i--;
+            int defined = instr->get_defined_var();
+            if (defined != 0 && readFirst.count(defined) == 0 && readers.count(defined) != 0 && readers[defined] == header)
+            {
+                if (renamed.count(defined) == 0)
+                    renamed[defined] = cfg->create_new_tempvar(INT);
+                params[0] = Operand::variable(renamed[defined]);
+            }
+            test->instrs->push_back(cfg->create_instr(test, instr->op, params));
+        }
+        test->test_var_index = renamed.count(header->test_var_index) != 0 ? renamed[header->test_var_index] : header->test_var_index;
+        test->set_exit_true(header->exit_true);
+        test->set_exit_false(header->exit_false);
+        for (auto latch : latches)
+        {
+            if (latch->exit_true == header)
+                latch->set_exit_true(test);
+            if (latch->exit_false == header)
+                latch->set_exit_false(test);
         }
+        cfg->add_bb(test);
+        // l'en-tête n'a plus que l'entrée pour prédécesseur
+        context.changed(header);
+        context.changed(test);
+        rotated++;
     }
+    return rotated;
+}
+
+int IROptimizer::unrollLoops(CFG *cfg, PassContext &context)
+{
+    // après la rotation, une boucle comptée ne teste qu'en fin de tour : les copies de son corps se suivent
+    // sans ce test tant qu'il reste assez de tours, voir LoopUnroller
+    if (context.settings.unrollFactor < 2)
+        return 0;
+    const DominatorTree &tree = context.dominators();
+    LoopNest loops(cfg, tree);
+    if (loops.get_loops().empty())
+        return 0;
+    int unrolled = LoopUnroller(cfg, tree, context.settings.unrollFactor, context.remarks).unroll(loops, [&context]() { return context.out_of_time(); });
+    if (unrolled != 0)
+        context.changed_all();
+    return unrolled;
+}
+
+int IROptimizer::layoutBasicBlocks(CFG *cfg, PassContext &context)
+{
+    // chaînes gloutonnes dans l'ordre postfixe inverse : chaque bloc est suivi d'un de ses
+    // successeurs pas encore placé (de préférence exit_true), pour qu'il soit atteint sans saut
+    const DominatorTree &tree = context.dominators();
+    vector<BasicBlock *> layout;
+    set<BasicBlock *> placed;
+    for (auto bb : tree.get_reverse_postorder())
+        while (bb != nullptr && placed.insert(bb).second)
+        {
+            layout.push_back(bb);
+            BasicBlock *next = nullptr;
+            if (bb->exit_true != nullptr && placed.find(bb->exit_true) == placed.end())
+                next = bb->exit_true;
+            else if (bb->exit_false != nullptr && placed.find(bb->exit_false) == placed.end())
+                next = bb->exit_false;
+            bb = next;
+        }
+
+    // blocs inatteignables restants, dans leur ordre d'origine
+    for (auto bb : *cfg->bbs)
+        if (placed.find(bb) == placed.end())
+            layout.push_back(bb);
+    int moved = 0;
+    for (unsigned long i = 0; i < layout.size(); i++)
+        if (layout[i] != (*cfg->bbs)[i])
+            moved++;
+    cfg->bbs->assign(layout.begin(), layout.end());
+    return moved;
 }
 
-void IROptimizer::removeUnusedBasicBlocks(CFG *cfg)
+int IROptimizer::simplifyCFG(CFG *cfg, PassContext &context)
 {
-    for (long unsigned i = 1; i < cfg->bbs->size(); i++)
+    // seuls les blocs modifiés depuis le dernier passage (leurs instructions ou leurs sorties) et leurs voisins
+    vector<BasicBlock *> changedBlocks = context.changed_blocks();
+    if (changedBlocks.empty())
+        return 0;
+    int changes = 0;
+    BasicBlock *entry = cfg->bbs->front();
+    unordered_set<BasicBlock *> removed;
+
+    // chaque modification d'un bloc remet dans la liste les blocs dont elle peut permettre de simplifier les sorties
+    vector<BasicBlock *> worklist;
+    auto revisit = [&worklist](BasicBlock *bb)
     {
-        bool toRemove = true;
-        BasicBlock *bb = (*cfg->bbs)[i];
-        for (auto bb2 : *cfg->bbs)
+        worklist.push_back(bb);
+        worklist.insert(worklist.end(), bb->predecessors->begin(), bb->predecessors->end());
+    };
+    // constantes connues à la fin des blocs dont on a replié les constantes : un bloc qui grandit par fusions
+    // successives ne replie que ses nouvelles instructions
+    unordered_map<BasicBlock *, map<int, int>> constantsAtEnd;
+
+    // blocs retirés, qui ne comptent plus parmi les prédécesseurs de leurs successeurs : ceux-ci sont revus
+    auto removeBlocks = [&](const vector<BasicBlock *> &blocks, vector<BasicBlock *> &orphans)
+    {
+        for (auto bb : blocks)
+            removed.insert(bb);
+        for (auto bb : blocks)
         {
-            if (bb == bb2)
-                continue;
-            if (bb2->exit_true == bb || bb2->exit_false == bb)
+            for (BasicBlock *succ : {bb->exit_true, bb->exit_false})
+                if (succ != nullptr && removed.find(succ) == removed.end())
+                    orphans.push_back(succ);
+            bb->detach();
+            changes++;
+        }
+    };
+    // bb et les blocs qui seuls le précèdent, si aucun chemin depuis l'entrée n'y mène : une boucle qui n'est plus atteinte.
+    // La recherche s'arrête après maxUnreachableSearch blocs, fullSearch demande alors un parcours depuis l'entrée
+    bool fullSearch = false;
+    auto unreachableRegion = [&](BasicBlock *bb, vector<BasicBlock *> &region)
+    {
+        region = {bb};
+        unordered_set<BasicBlock *> seen = {bb};
+        for (unsigned long i = 0; i < region.size(); i++)
+            for (auto pred : *region[i]->predecessors)
             {
-                toRemove = false;
-                break;
-            }
-            for (auto instr : *bb2->instrs)
-                if (instr->op == jump && instr->params[0] == bb->label)
+                if (pred == entry)
+                    return false;
+                if (!seen.insert(pred).second)
+                    continue;
+                if (region.size() == maxUnreachableSearch)
                 {
-                    toRemove = false;
-                    break;
+                    fullSearch = true;
+                    return false;
                 }
-            if (!toRemove)
-                break;
+                region.push_back(pred);
+            }
+        return true;
+    };
+    // après la perte d'un prédécesseur : un bloc qui n'en a plus, ou qui n'est plus atteint, est retiré ;
+    // un bloc qui n'en a plus qu'un peut être fusionné
+    auto lostPredecessors = [&](vector<BasicBlock *> orphans)
+    {
+        vector<BasicBlock *> region;
+        while (!orphans.empty())
+        {
+            BasicBlock *bb = orphans.back();
+            orphans.pop_back();
+            if (bb == nullptr || bb == entry || removed.find(bb) != removed.end())
+                continue;
+            if (unreachableRegion(bb, region))
+                removeBlocks(region, orphans);
+            else if (bb->predecessors->size() == 1)
+                worklist.push_back(bb->predecessors->front());
         }
-        if (toRemove)
+    };
+    auto lostPredecessor = [&](BasicBlock *succ) { lostPredecessors({succ}); };
+    // blocs inatteignables depuis l'entrée
+    auto removeUnreachable = [&]()
+    {
+        unordered_set<BasicBlock *> reachable = {entry};
+        vector<BasicBlock *> stack = {entry};
+        while (!stack.empty())
         {
-            cfg->bbs->erase(cfg->bbs->begin() + i);
-            i--;
+            BasicBlock *bb = stack.back();
+            stack.pop_back();
+            for (BasicBlock *succ : {bb->exit_true, bb->exit_false})
+                if (succ != nullptr && reachable.insert(succ).second)
+                    stack.push_back(succ);
         }
-    }
-}
-
-void IROptimizer::bypassEmptyIntermediateBlocks(CFG *cfg)
-{
-    for (auto bb : *cfg->bbs)
+        vector<BasicBlock *> unreachable, orphans;
+        for (auto bb : *cfg->bbs)
+            if (reachable.find(bb) == reachable.end() && removed.find(bb) == removed.end())
+                unreachable.push_back(bb);
+        removeBlocks(unreachable, orphans);
+        lostPredecessors(orphans);
+    };
+
+    // les blocs modifiés ont pu perdre des prédécesseurs. Quand ils sont nombreux, un parcours depuis l'entrée coûte moins
+    if (changedBlocks.size() * maxUnreachableSearch > cfg->bbs->size())
+        removeUnreachable();
+    else
+        lostPredecessors(changedBlocks);
+    for (auto it = changedBlocks.rbegin(); it != changedBlocks.rend(); it++)
+        if (removed.find(*it) == removed.end())
+            revisit(*it);
+
+    // à court de temps, les blocs restants ne sont pas simplifiés : le CFG reste juste
+    while ((!worklist.empty() || fullSearch) && !context.out_of_time())
     {
-        bool hasChanged = true;
-        while (hasChanged)
+        if (worklist.empty())
         {
-            hasChanged = false;
-            if (bb->exit_true != nullptr && bb->exit_true->instrs->empty() && bb->exit_true->exit_false == nullptr)
-            {
-                bb->exit_true = bb->exit_true->exit_true;
-                hasChanged = true;
-            }
-            if (bb->exit_false != nullptr && bb->exit_false->instrs->empty() && bb->exit_false->exit_false == nullptr)
+            fullSearch = false;
+            removeUnreachable();
+            continue;
+        }
+        BasicBlock *bb = worklist.back();
+        worklist.pop_back();
+        if (removed.find(bb) != removed.end())
+            continue;
+
+        // un test de variable constante : une seule des deux sorties reste
+        BasicBlock *dropped = foldConstantBranch(bb);
+        if (dropped != nullptr)
+        {
+            lostPredecessor(dropped);
+            revisit(bb);
+            changes++;
+        }
+
+        // une sortie vers un bloc vide sans condition va directement à la sortie de celui-ci
+        for (bool trueExit : {true, false})
+        {
+            BasicBlock *target = trueExit ? bb->exit_true : bb->exit_false;
+            vector<BasicBlock *> chain; // une boucle de blocs vides est laissée telle quelle
+            while (target != nullptr && target->instrs->empty() && target->exit_false == nullptr
+                   && (target->exit_true != nullptr || (trueExit && bb->exit_false == nullptr))
+                   && find(chain.begin(), chain.end(), target) == chain.end())
             {
-                bb->exit_false = bb->exit_false->exit_true;
-                hasChanged = true;
+                chain.push_back(target);
+                target = target->exit_true;
             }
+            if (chain.empty() || target == chain.front())
+                continue;
+            if (trueExit)
+                bb->set_exit_true(target);
+            else
+                bb->set_exit_false(target);
+            lostPredecessor(chain.front());
+            revisit(bb);
+            changes++;
+        }
+
+        // un saut vers un bloc qui n'a pas d'autre prédécesseur : les deux blocs n'en font qu'un.
+        // Si le bloc obtenu se termine par un test, ses constantes sont repliées aussitôt : le test peut devenir constant
+        BasicBlock *next = bb->exit_true;
+        if (bb->exit_false == nullptr && next != nullptr && next != bb && next != entry && next->predecessors->size() == 1)
+        {
+            unsigned long merged = bb->instrs->size();
+            bb->instrs->insert(bb->instrs->end(), next->instrs->begin(), next->instrs->end());
+            bb->test_var_index = next->test_var_index;
+            BasicBlock *exitTrue = next->exit_true;
+            BasicBlock *exitFalse = next->exit_false;
+            next->detach();
+            removed.insert(next);
+            bb->set_exit_true(exitTrue);
+            bb->set_exit_false(exitFalse);
+            auto constants = constantsAtEnd.find(bb);
+            if (constants != constantsAtEnd.end())
+                foldConstantsFrom(bb, merged, constants->second);
+            else if (bb->exit_false != nullptr)
+                foldConstantsFrom(bb, 0, constantsAtEnd[bb]);
+            revisit(bb);
+            context.changed(bb);
+            changes++;
         }
     }
+
+    cfg->bbs->erase(remove_if(cfg->bbs->begin(), cfg->bbs->end(), [&removed](BasicBlock *bb)
+                              { return removed.find(bb) != removed.end(); }),
+                    cfg->bbs->end());
+    return changes;
 }
@@ -1,28 +1,58 @@
 #pragma once
 
+#include <chrono>
+#include <ostream>
+
 #include "CFG.h"
+#include "PassManager.h"
 
 using namespace std;
 
+/** Optimizations of the IR, run function by function by a PassManager
+
+   Each optimization level has its own pipeline (see pipeline()):
+     -O0: only the lowering that gen_asm needs (nothing after a jump or a return, exits instead of jumps),
+     -O1: folding of constants in the blocks, dead code elimination, cleanup of the CFG, rotation and unrolling of the loops,
+     -O2: in addition, global passes in SSA form, down to the strength reduction and the closed forms of the loops.
+   Each pass returns the number of changes it made.
+*/
 class IROptimizer
 {
 public:
-    explicit IROptimizer(vector<CFG *> *cfgList);
-    void optimize() const;
+    IROptimizer(vector<CFG *> *cfgList, int optimizationLevel = 1, chrono::milliseconds passBudget = defaultPassBudget, PassSettings settings = PassSettings());
+    void optimize();
+    void optimizeFunction(CFG *cfg, ostream *remarks = nullptr); /**< whole pipeline on a single function, functions being independent they can be optimized in parallel */
+    void report(ostream &o) const; /**< statistics of the passes, over all the functions optimized so far */
+
+    static vector<PipelineStep> pipeline(int optimizationLevel);
+    static bool foldOperation(Operation op, const vector<int> &operands, int &result); /**< value of an operation on constants, with the wraparound of the compiled code, false if it is not defined at compile time (division by 0...) */
+    static constexpr chrono::milliseconds defaultPassBudget{0}; /**< time a pass may spend on one function, 0 for no limit: a budget makes the output depend on the machine */
+    static const unsigned long maxRotatedTest = 12; /**< instructions of the test of a loop, beyond which rotateLoops leaves it */
+    static const unsigned long maxUnreachableSearch = 64; /**< blocks searched back from a block that lost a predecessor, beyond which simplifyCFG looks for the unreachable blocks from the entry */
 
 protected:
-    static void constantVariableOptimization(BasicBlock *bb);
-    static void unusedVariables(CFG *cfg);
-    static void deadCodeRemoval(BasicBlock *bb);
-    static void optimizeCFG(CFG *cfg);
-    static bool simplifyConditionnalBlockJump(CFG *cfg);
-    static void bypassEmptyIntermediateBlocks(CFG *cfg);
-    static void removeUnusedBasicBlocks(CFG *cfg);
-    static void mergeBasicBlocks(CFG *cfg);
-    static bool reduce(BasicBlock *bb, int index, int value, IRInstr *instr, map<string, string> *constVars);
+    static int constantVariableOptimization(BasicBlock *bb);
+    static int foldConstantsFrom(BasicBlock *bb, unsigned long from, map<int, int> &constVars); /**< from the instruction from on, constVars: the constants known before it, then at the end of the block */
+    static int deadCodeElimination(CFG *cfg, PassContext &context); /**< removes the instructions whose result is never read, see Liveness */
+    static int copyPropagation(CFG *cfg, PassContext &context); /**< reads y instead of x where a copy x = y is available, see AvailableCopies */
+    static int coalesceCopies(CFG *cfg, PassContext &context); /**< merges the variables of the remaining copies, see CopyCoalescer */
+    static int sparseConditionalConstantPropagation(CFG *cfg, PassContext &context);
+    static int globalValueNumbering(CFG *cfg, PassContext &context); /**< removes the computations already made in a dominating block, see ValueNumbering */
+    static int loopInvariantCodeMotion(CFG *cfg, PassContext &context); /**< moves the computations that do not depend on the loop to its preheader, see LoopNest */
+    static int reduceInductionStrength(CFG *cfg, PassContext &context); /**< turns the products of induction variables by invariants into additions, see ScalarEvolution */
+    static int replaceLoopExitValues(CFG *cfg, PassContext &context); /**< removes the loops that only compute values used after them, see ScalarEvolution */
+    static int ssaDeadCodeElimination(CFG *cfg, PassContext &context);
+    static int deadCodeRemoval(BasicBlock *bb);
+    static int simplifyConditionnalBlockJump(CFG *cfg, PassContext &context); /**< on the blocks changed since its last run */
+    static BasicBlock *foldConstantBranch(BasicBlock *bb); /**< the exit no longer taken, nullptr if the tested variable is not a constant */
+    static int threadConditionalJumps(CFG *cfg, PassContext &context);
+    static int simplifyCFG(CFG *cfg, PassContext &context); /**< removes the unreachable blocks, folds the constant branches, bypasses the empty blocks and merges the chains, in a worklist of the blocks changed since its last run */
+    static int rotateLoops(CFG *cfg, PassContext &context); /**< copies the test of a loop at its end: a guard before the loop and a single branch back per iteration */
+    static int unrollLoops(CFG *cfg, PassContext &context); /**< copies the body of the counted loops, see LoopUnroller */
+    static int layoutBasicBlocks(CFG *cfg, PassContext &context);
+    static bool reduce(BasicBlock *bb, int index, int value, IRInstr *instr, map<int, int> *constVars);
+    static int replaceJumpInstructions(CFG *cfg);
+    static int removeExitWhenReturn(CFG *cfg);
     vector<CFG *> *cfgs;
-
-    void replaceJumpInstructions() const;
-
-    void removeExitWhenReturn() const;
+    PassManager passManager;
 };
@@ -0,0 +1,11 @@
+#include "Identifiers.h"
+
+int Identifiers::intern(string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end())
+        return it->second;
+    names.emplace_back(name);
+    int id = names.size() - 1;
+    ids.emplace(names.back(), id);
+    return id;
+}
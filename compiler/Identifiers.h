@@ -0,0 +1,25 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+/** Interned identifiers of a source file
+
+   Each distinct name gets a small integer id, in order of first appearance: the symbol tables of
+   the CFGs are indexed by these ids, so looking up a variable never hashes or compares a string.
+   The native front end interns the names once, in its lexer; CToIRVisitor when it meets them.
+*/
+class Identifiers {
+public:
+    int intern(string_view name); /**< id of the name, a new one the first time */
+    const string &get_name(int id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+
+protected:
+    deque<string> names; /**< by id, a deque does not move them: the keys of ids point into them */
+    unordered_map<string_view, int> ids;
+};
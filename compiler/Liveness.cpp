@@ -0,0 +1,126 @@
+#include "Liveness.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+Liveness::Numbering Liveness::numberVariables(CFG *cfg)
+{
+    // une variable lue dans un bloc avant d'y être écrite peut être vivante d'un bloc à l'autre,
+    // les autres (la plupart des temporaires) ne vivent que dans leur bloc
+    vector<int> acrossBlocks;
+    vector<int> local;
+    unordered_set<int> defined;
+    for (auto bb : *cfg->bbs)
+    {
+        defined.clear();
+        for (auto instr : *bb->instrs)
+        {
+            for (int var : instr->get_used_vars())
+                (defined.count(var) == 0 ? acrossBlocks : local).push_back(var);
+            int def = instr->get_defined_var();
+            if (def != 0)
+            {
+                defined.insert(def);
+                local.push_back(def);
+            }
+        }
+        if (bb->exit_false != nullptr)
+            (defined.count(bb->test_var_index) == 0 ? acrossBlocks : local).push_back(bb->test_var_index);
+    }
+
+    Numbering numbering;
+    sort(acrossBlocks.begin(), acrossBlocks.end());
+    acrossBlocks.erase(unique(acrossBlocks.begin(), acrossBlocks.end()), acrossBlocks.end());
+    sort(local.begin(), local.end());
+    local.erase(unique(local.begin(), local.end()), local.end());
+    numbering.variables = acrossBlocks;
+    for (int var : local)
+        if (!binary_search(acrossBlocks.begin(), acrossBlocks.end(), var))
+            numbering.variables.push_back(var);
+    numbering.acrossBlocks = acrossBlocks.size();
+    return numbering;
+}
+
+Liveness::Liveness(CFG *cfg, bool strong, const function<bool()> &stop) : Liveness(cfg, strong, numberVariables(cfg), stop) {}
+
+Liveness::Liveness(CFG *cfg, bool strong, Numbering numbering, const function<bool()> &stop)
+    : Dataflow(cfg, numbering.acrossBlocks, BACKWARD, UNION), strong(strong), variables(std::move(numbering.variables))
+{
+    for (size_t i = 0; i < variables.size(); i++)
+        numbers[variables[i]] = i;
+
+    // forte, la vivacité d'une instruction dépend de celle de son résultat : pas d'ensembles fixes par bloc
+    if (!strong)
+    {
+        gens.assign(blocks.size(), BitVector(universe));
+        kills.assign(blocks.size(), BitVector(universe));
+        for (size_t b = 0; b < blocks.size(); b++)
+        {
+            // gen : variables lues dans le bloc avant d'y être écrites (le test est lu à la fin), kill : variables écrites
+            BitVector live(variables.size());
+            if (blocks[b]->exit_false != nullptr)
+                live.set(numbers[blocks[b]->test_var_index]);
+            for (auto it = blocks[b]->instrs->rbegin(); it != blocks[b]->instrs->rend(); it++)
+            {
+                step(*it, live);
+                int defined = (*it)->get_defined_var();
+                if (defined != 0 && (size_t)numbers[defined] < universe)
+                    kills[b].set(numbers[defined]);
+            }
+            live.resize(universe);
+            gens[b] = live;
+        }
+    }
+    solved = solve(stop);
+}
+
+int Liveness::number(int var) const
+{
+    auto it = numbers.find(var);
+    return it == numbers.end() ? -1 : it->second;
+}
+
+BitVector Liveness::live_after_instructions(BasicBlock *bb) const
+{
+    BitVector live = out(bb);
+    live.resize(variables.size());
+    if (bb->exit_false != nullptr)
+        live.set(numbers.at(bb->test_var_index));
+    return live;
+}
+
+bool Liveness::is_useful(const IRInstr *instr, const BitVector &liveAfter) const
+{
+    if (!strong)
+        return true;
+    int defined = instr->get_defined_var();
+    return defined == 0 || instr->op == call || liveAfter.test(numbers.at(defined));
+}
+
+void Liveness::step(const IRInstr *instr, BitVector &live) const
+{
+    int defined = instr->get_defined_var();
+    if (defined != 0)
+        live.reset(numbers.at(defined));
+    for (int var : instr->get_used_vars())
+        live.set(numbers.at(var));
+}
+
+void Liveness::transfer(BasicBlock *bb, BitVector &value) const
+{
+    if (!strong)
+    {
+        Dataflow::transfer(bb, value);
+        return;
+    }
+    // les variables locales au bloc n'ont de place que pendant le parcours de ses instructions
+    BitVector live = value;
+    live.resize(variables.size());
+    if (bb->exit_false != nullptr)
+        live.set(numbers.at(bb->test_var_index));
+    for (auto it = bb->instrs->rbegin(); it != bb->instrs->rend(); it++)
+        if (is_useful(*it, live))
+            step(*it, live);
+    live.resize(universe);
+    value = live;
+}
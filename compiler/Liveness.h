@@ -0,0 +1,53 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "Dataflow.h"
+
+using namespace std;
+
+/** Live variables of a CFG: the variables whose current value may still be read
+
+   A backward Dataflow analysis over a dense numbering of the variables of the function (its
+   offsets are sparse and negative). A block reads its instructions' operands and, at its end, its
+   test variable. Only the variables read in some block before being written there can be live
+   from one block to another: they come first in the numbering and are the only ones in in() and
+   out(). The others, most temporaries, have their bits in the values of the walks through a block
+   (live_after_instructions(), step()).
+   With strong = true, the operands of an instruction whose result is never read are not live
+   either (strong liveness): chains and cycles of useless computations are dead as a whole, which
+   is what a dead code elimination needs. Calls, returns and jumps are always useful.
+
+   The analysis is solved by the constructor, on the CFG as it is then, unless stop() ends it before
+   (see Dataflow::solve): is_solved() must then be checked.
+*/
+class Liveness : public Dataflow
+{
+public:
+    explicit Liveness(CFG *cfg, bool strong = false, const function<bool()> &stop = nullptr);
+    bool is_solved() const { return solved; } /**< false if stop() ended the analysis, whose values are then wrong */
+
+    int number(int var) const; /**< position of a variable in the bit vectors, -1 if the function does not use it */
+    int variable(size_t number) const { return variables[number]; }
+
+    BitVector live_after_instructions(BasicBlock *bb) const; /**< out(bb) and the test variable of bb */
+    bool is_useful(const IRInstr *instr, const BitVector &liveAfter) const; /**< always true if not strong */
+    void step(const IRInstr *instr, BitVector &live) const; /**< live after instr -> live before it */
+
+protected:
+    struct Numbering
+    {
+        vector<int> variables;
+        size_t acrossBlocks; /**< the first variables, read in a block before being written there */
+    };
+
+    Liveness(CFG *cfg, bool strong, Numbering numbering, const function<bool()> &stop);
+    static Numbering numberVariables(CFG *cfg);
+    void transfer(BasicBlock *bb, BitVector &value) const override;
+
+    bool strong;
+    bool solved;
+    vector<int> variables; /**< by number */
+    unordered_map<int, int> numbers;
+};
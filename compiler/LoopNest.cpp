@@ -0,0 +1,155 @@
+#include "LoopNest.h"
+
+#include <algorithm>
+
+vector<pair<BasicBlock *, BasicBlock *>> Loop::exits() const
+{
+    vector<pair<BasicBlock *, BasicBlock *>> edges;
+    for (auto bb : blocks)
+        for (auto succ : DominatorTree::successors(bb))
+            if (!contains(succ))
+                edges.emplace_back(bb, succ);
+    return edges;
+}
+
+LoopNest::LoopNest(CFG *cfg, const DominatorTree &tree) : cfg(cfg)
+{
+    // un arc retour mène à un dominateur de sa source ; le corps est ce qui remonte à la source sans passer par l'en-tête.
+    // Un dominateur précède ses blocs dans l'ordre postfixe inverse : seuls les arcs qui y reculent sont à tester
+    const vector<BasicBlock *> &reversePostorder = tree.get_reverse_postorder();
+    unordered_map<BasicBlock *, unsigned long> positions;
+    for (unsigned long i = 0; i < reversePostorder.size(); i++)
+        positions[reversePostorder[i]] = i;
+    unordered_map<BasicBlock *, Loop *> byHeader;
+    for (auto header : reversePostorder)
+        for (auto latch : tree.get_predecessors(header))
+        {
+            if (positions[latch] < positions[header] || !tree.dominates(header, latch))
+                continue;
+            Loop *&loop = byHeader[header];
+            if (loop == nullptr)
+            {
+                loops.push_back(make_unique<Loop>());
+                loop = loops.back().get();
+                loop->header = header;
+                loop->members.insert(header);
+            }
+            loop->latches.push_back(latch);
+            vector<BasicBlock *> worklist = {latch};
+            while (!worklist.empty())
+            {
+                BasicBlock *bb = worklist.back();
+                worklist.pop_back();
+                if (!loop->members.insert(bb).second)
+                    continue;
+                for (auto pred : tree.get_predecessors(bb))
+                    worklist.push_back(pred);
+            }
+        }
+
+    // deux boucles naturelles d'en-têtes différents sont disjointes ou imbriquées :
+    // en partant des plus grandes, la boucle la plus interne connue d'un en-tête est la boucle parente
+    for (auto &loop : loops)
+        order.push_back(loop.get());
+    stable_sort(order.begin(), order.end(), [](Loop *a, Loop *b) { return a->members.size() > b->members.size(); });
+    for (Loop *loop : order)
+    {
+        auto parent = innermost.find(loop->header);
+        if (parent != innermost.end())
+        {
+            loop->parent = parent->second;
+            loop->depth = loop->parent->depth + 1;
+            loop->parent->children.push_back(loop);
+        }
+        for (auto bb : loop->members)
+            innermost[bb] = loop;
+    }
+    reverse(order.begin(), order.end());
+
+    for (auto bb : reversePostorder)
+        for (Loop *loop = get_loop(bb); loop != nullptr; loop = loop->parent)
+            loop->blocks.push_back(bb);
+
+    for (Loop *loop : order)
+    {
+        vector<BasicBlock *> entries;
+        for (auto pred : tree.get_predecessors(loop->header))
+            if (!loop->contains(pred))
+                entries.push_back(pred);
+        if (entries.size() == 1 && entries.front()->exit_true == loop->header && entries.front()->exit_false == nullptr)
+            loop->preheader = entries.front();
+    }
+}
+
+Loop *LoopNest::get_loop(BasicBlock *bb) const
+{
+    auto it = innermost.find(bb);
+    return it == innermost.end() ? nullptr : it->second;
+}
+
+int LoopNest::create_preheaders()
+{
+    int created = 0;
+    for (Loop *loop : order)
+    {
+        if (loop->preheader != nullptr)
+            continue;
+        BasicBlock *header = loop->header;
+        auto preheader = cfg->create_bb(cfg->new_BB_name("preheader"));
+
+        // les arcs entrant dans la boucle passent désormais par le préen-tête
+        vector<BasicBlock *> entries;
+        for (auto pred : *header->predecessors)
+            if (!loop->contains(pred) && find(entries.begin(), entries.end(), pred) == entries.end())
+                entries.push_back(pred);
+        for (auto pred : entries)
+        {
+            if (pred->exit_true == header)
+                pred->set_exit_true(preheader);
+            if (pred->exit_false == header)
+                pred->set_exit_false(preheader);
+        }
+        preheader->set_exit_true(header);
+
+        // en SSA, les opérandes des phi venant de l'extérieur arrivent par le préen-tête, fusionnés par un phi s'ils diffèrent
+        for (auto instr : *header->instrs)
+        {
+            if (instr->op != phi)
+                break;
+            vector<Operand> params = {instr->params[0]};
+            vector<Operand> entering;
+            for (unsigned long i = 1; i < instr->params.size(); i += 2)
+            {
+                vector<Operand> &kept = loop->contains(instr->params[i].get_block()) ? params : entering;
+                kept.push_back(instr->params[i]);
+                kept.push_back(instr->params[i + 1]);
+            }
+            if (entering.empty())
+                continue;
+            Operand value = entering[1];
+            for (unsigned long i = 3; i < entering.size(); i += 2)
+                if (entering[i] != value)
+                {
+                    value = Operand::variable(cfg->create_new_tempvar(INT));
+                    entering.insert(entering.begin(), value);
+                    preheader->instrs->push_back(cfg->create_instr(preheader, phi, entering));
+                    break;
+                }
+            params.push_back(Operand::label(preheader));
+            params.push_back(value);
+            instr->params.assign(params.begin(), params.end());
+        }
+
+        cfg->bbs->insert(find(cfg->bbs->begin(), cfg->bbs->end(), header), preheader);
+        loop->preheader = preheader;
+        if (loop->parent != nullptr)
+            innermost[preheader] = loop->parent;
+        for (Loop *outer = loop->parent; outer != nullptr; outer = outer->parent)
+        {
+            outer->members.insert(preheader);
+            outer->blocks.insert(find(outer->blocks.begin(), outer->blocks.end(), header), preheader);
+        }
+        created++;
+    }
+    return created;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "CFG.h"
+#include "DominatorTree.h"
+
+using namespace std;
+
+/** A natural loop: a header and the blocks from which a back edge to the header can be reached without going through it */
+struct Loop
+{
+    BasicBlock *header;
+    vector<BasicBlock *> blocks; /**< the header first, then the other blocks in reverse postorder */
+    vector<BasicBlock *> latches; /**< sources of the back edges */
+    BasicBlock *preheader = nullptr; /**< the only predecessor out of the loop, when the header is its only successor */
+    Loop *parent = nullptr; /**< innermost loop containing this one */
+    vector<Loop *> children;
+    int depth = 1; /**< 1 for an outermost loop */
+
+    bool contains(BasicBlock *bb) const { return members.count(bb) != 0; }
+    vector<pair<BasicBlock *, BasicBlock *>> exits() const; /**< edges leaving the loop: (block of the loop, block out of it) */
+
+protected:
+    friend class LoopNest;
+    unordered_set<BasicBlock *> members;
+};
+
+/** Loop nest of a CFG
+
+   A back edge goes from a block to one of its dominators, its header. The loops of the back edges
+   to a same header are merged into one loop (the CFGs of the front end have a single back edge per
+   loop: the end of the body, or the for_after block, to the test). Loops are nested when one
+   contains the header of the other. Unreachable blocks are in no loop.
+
+   create_preheaders() gives each loop a preheader, an empty block that becomes the only entry of
+   the loop: the invariant code of the loop can be moved there. In SSA form, the phi instructions of
+   the header get their operands from out of the loop through the preheader. It changes the control
+   flow, so the DominatorTree given to the constructor is no longer valid.
+*/
+class LoopNest
+{
+public:
+    LoopNest(CFG *cfg, const DominatorTree &tree);
+
+    const vector<Loop *> &get_loops() const { return order; } /**< innermost loops first: a loop comes after all the loops it contains */
+    Loop *get_loop(BasicBlock *bb) const; /**< innermost loop containing bb, nullptr if there is none */
+    int create_preheaders(); /**< number of preheaders created */
+
+protected:
+    CFG *cfg;
+    vector<unique_ptr<Loop>> loops;
+    vector<Loop *> order;
+    unordered_map<BasicBlock *, Loop *> innermost;
+};
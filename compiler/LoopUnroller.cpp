@@ -0,0 +1,348 @@
+#include "LoopUnroller.h"
+#include "IROptimizer.h"
+
+#include <algorithm>
+#include <climits>
+#include <unordered_map>
+#include <unordered_set>
+
+LoopUnroller::LoopUnroller(CFG *cfg, const DominatorTree &tree, int factor, ostream *remarks) :
+    cfg(cfg), tree(tree), factor(factor), remarks(remarks) {}
+
+int LoopUnroller::unroll(const LoopNest &loops, const function<bool()> &stop)
+{
+    // seules les boucles les plus internes sont déroulées : elles sont disjointes, dérouler l'une ne change
+    // ni les autres ni les dominateurs de leurs blocs entre eux
+    int unrolled = 0;
+    for (Loop *loop : loops.get_loops())
+    {
+        if (stop && stop())
+        {
+            remark(loop, "not unrolled: out of time");
+            continue;
+        }
+        CountedLoop counted;
+        string reason;
+        if (!analyze(loop, counted, reason))
+        {
+            remark(loop, "not unrolled: " + reason);
+            continue;
+        }
+
+        int trips;
+        if (tripCount(counted, trips) && trips * counted.size <= maxUnrolledSize)
+        {
+            fullyUnroll(counted, trips);
+            remark(loop, "fully unrolled, " + to_string(trips) + (trips == 1 ? " iteration" : " iterations"));
+            unrolled++;
+            continue;
+        }
+
+        int copies = factor;
+        while (copies > 1 && copies * counted.size > maxUnrolledSize)
+            copies--;
+        if (copies < 2)
+        {
+            remark(loop, "not unrolled: body of " + to_string(counted.size) + " instructions, beyond the size budget");
+            continue;
+        }
+        if (!unrollWithRemainder(counted, copies, reason))
+        {
+            remark(loop, "not unrolled: " + reason);
+            continue;
+        }
+        remark(loop, "unrolled " + to_string(copies) + " times, with a remainder loop");
+        unrolled++;
+    }
+    return unrolled;
+}
+
+bool LoopUnroller::analyze(Loop *loop, CountedLoop &counted, string &reason) const
+{
+    counted.loop = loop;
+    if (!loop->children.empty())
+    {
+        reason = "it contains another loop";
+        return false;
+    }
+    if (loop->header == cfg->bbs->front())
+    {
+        reason = "it starts the function";
+        return false;
+    }
+    vector<pair<BasicBlock *, BasicBlock *>> exits = loop->exits();
+    BasicBlock *latch = loop->latches.front();
+    if (loop->latches.size() != 1 || exits.size() != 1 || exits.front().first != latch || latch->exit_false == nullptr)
+    {
+        reason = "it does not leave only by the test at its end";
+        return false;
+    }
+    counted.latch = latch;
+    counted.exit = exits.front().second;
+
+    unordered_map<int, int> definitions;
+    counted.size = 0;
+    for (auto bb : loop->blocks)
+    {
+        counted.size += bb->instrs->size();
+        for (auto instr : *bb->instrs)
+            if (instr->get_defined_var() != 0)
+                definitions[instr->get_defined_var()]++;
+    }
+
+    // la comparaison testée, dernière écriture de la variable de test
+    unsigned long position = latch->instrs->size();
+    IRInstr *test = nullptr;
+    while (position > 0 && test == nullptr)
+        if ((*latch->instrs)[--position]->get_defined_var() == latch->test_var_index)
+            test = (*latch->instrs)[position];
+    if (test == nullptr || (test->op != cmp_lt && test->op != cmp_le && test->op != cmp_gt && test->op != cmp_ge))
+    {
+        reason = "its test is not an order comparison";
+        return false;
+    }
+
+    // la variable d'induction : l'opérande comparé écrit une seule fois dans la boucle, par un pas constant avant le test
+    for (unsigned long side = 1; side <= 2; side++)
+    {
+        const Operand &candidate = test->params[side];
+        const Operand &other = test->params[3 - side];
+        if (!candidate.is_variable() || definitions[candidate.get_index()] != 1)
+            continue;
+        if (other.is_variable() && (definitions.count(other.get_index()) != 0 || other == candidate))
+            continue;
+        int var = candidate.get_index();
+        long long step = 0;
+        for (auto bb : loop->blocks)
+        {
+            // écrite une fois par tour : dans un bloc qui domine le latch, ou dans le latch avant le test
+            if (bb != latch && !tree.dominates(bb, latch))
+                continue;
+            for (unsigned long i = 0; i < (bb == latch ? position : bb->instrs->size()); i++)
+            {
+                IRInstr *instr = (*bb->instrs)[i];
+                if (instr->get_defined_var() != var)
+                    continue;
+                const ArenaVector<Operand> &params = instr->params;
+                if ((instr->op == incr || instr->op == decr) && params.back() == candidate)
+                    step = instr->op == incr ? 1 : -1;
+                else if (instr->op == add && params[1] == candidate && params[2].is_immediate())
+                    step = params[2].get_value();
+                else if (instr->op == add && params[2] == candidate && params[1].is_immediate())
+                    step = params[1].get_value();
+                else if (instr->op == sub && params[1] == candidate && params[2].is_immediate())
+                    step = -(long long)params[2].get_value();
+            }
+        }
+        if (step == 0 || step > INT_MAX || step < -INT_MAX)
+            continue;
+
+        counted.induction = var;
+        counted.step = step;
+        counted.bound = other;
+        counted.condition = side == 1 ? test->op : mirrored(test->op);
+        if (latch->exit_true != loop->header)
+            counted.condition = negated(counted.condition);
+        if ((counted.condition == cmp_lt || counted.condition == cmp_le) != (step > 0))
+        {
+            reason = "its induction variable moves away from its bound";
+            return false;
+        }
+        return true;
+    }
+    reason = "no induction variable with a constant step is compared to an invariant bound";
+    return false;
+}
+
+bool LoopUnroller::tripCount(const CountedLoop &counted, int &trips) const
+{
+    if (!counted.bound.is_immediate())
+        return false;
+    BasicBlock *entry = nullptr;
+    for (auto pred : *counted.loop->header->predecessors)
+        if (!counted.loop->contains(pred))
+        {
+            if (entry != nullptr && entry != pred)
+                return false;
+            entry = pred;
+        }
+
+    // valeur de la variable d'induction à l'entrée : sa dernière écriture, en remontant les blocs à un seul prédécesseur
+    unordered_set<BasicBlock *> visited;
+    int value = 0;
+    bool found = false;
+    for (BasicBlock *bb = entry; !found; )
+    {
+        if (bb == nullptr || !visited.insert(bb).second)
+            return false;
+        for (auto it = bb->instrs->rbegin(); it != bb->instrs->rend() && !found; it++)
+        {
+            if ((*it)->get_defined_var() != counted.induction)
+                continue;
+            if (((*it)->op != ldconst && (*it)->op != copyvar) || !(*it)->params[1].is_immediate())
+                return false;
+            value = (*it)->params[1].get_value();
+            found = true;
+        }
+        BasicBlock *pred = nullptr;
+        for (auto p : *bb->predecessors)
+        {
+            if (pred != nullptr && pred != p)
+            {
+                pred = nullptr;
+                break;
+            }
+            pred = p;
+        }
+        bb = pred;
+    }
+
+    // le corps est exécuté une fois en entrant, puis tant que le test en fin de tour est vrai (avec le débordement du code compilé)
+    for (trips = 1; trips <= maxFullUnrollTrips; trips++)
+    {
+        int holds;
+        IROptimizer::foldOperation(add, {value, (int)counted.step}, value);
+        IROptimizer::foldOperation(counted.condition, {value, counted.bound.get_value()}, holds);
+        if (!holds)
+            return true;
+    }
+    return false;
+}
+
+BasicBlock *LoopUnroller::copyBody(const CountedLoop &counted, BasicBlock *&latch)
+{
+    unordered_map<BasicBlock *, BasicBlock *> copies;
+    for (auto bb : counted.loop->blocks)
+        copies[bb] = cfg->create_bb(cfg->new_BB_name("unrolled"));
+    for (auto bb : counted.loop->blocks)
+    {
+        BasicBlock *copy = copies[bb];
+        for (auto instr : *bb->instrs)
+            copy->instrs->push_back(cfg->create_instr(copy, instr->op, vector<Operand>(instr->params.begin(), instr->params.end())));
+        copy->test_var_index = bb->test_var_index;
+        copy->set_exit_true(counted.loop->contains(bb->exit_true) ? copies[bb->exit_true] : bb->exit_true);
+        copy->set_exit_false(counted.loop->contains(bb->exit_false) ? copies[bb->exit_false] : bb->exit_false);
+        cfg->add_bb(copy);
+    }
+    latch = copies[counted.latch];
+    return copies[counted.loop->header];
+}
+
+void LoopUnroller::fullyUnroll(const CountedLoop &counted, int trips)
+{
+    // les copies du corps se suivent sans test, la dernière sort de la boucle
+    BasicBlock *previous = nullptr;
+    for (int i = 0; i < trips; i++)
+    {
+        BasicBlock *latch;
+        BasicBlock *header = copyBody(counted, latch);
+        if (previous == nullptr)
+            redirectEntries(counted, header);
+        else
+            previous->set_exit_true(header);
+        latch->set_exit_false(nullptr);
+        previous = latch;
+    }
+    previous->set_exit_true(counted.exit);
+}
+
+bool LoopUnroller::unrollWithRemainder(const CountedLoop &counted, int copies, string &reason)
+{
+    // i condition n - offset garantit que les copies - 1 tests suivants sont vrais : i + k * step condition n pour k < copies
+    long long offset = (copies - 1) * counted.step;
+    const Operand &bound = counted.bound;
+    Operand limit;
+    if (bound.is_immediate())
+    {
+        long long value = bound.get_value() - offset;
+        if (value < INT_MIN || value > INT_MAX)
+        {
+            reason = "its bound is too close to the limits of int";
+            return false;
+        }
+        limit = Operand::immediate((int)value);
+    }
+    else if (offset > INT_MAX || offset < -INT_MAX)
+    {
+        reason = "its step is too large";
+        return false;
+    }
+    BasicBlock *header = counted.loop->header;
+    Operand induction = Operand::variable(counted.induction);
+
+    // garde : assez de tours pour une itération déroulée, sinon la boucle d'origine fait tout
+    auto guard = cfg->create_bb(cfg->new_BB_name("unroll_guard"));
+    redirectEntries(counted, guard);
+    cfg->add_bb(guard);
+    BasicBlock *check = guard;
+    if (bound.is_variable())
+    {
+        // n - offset ne doit pas déborder
+        int safe = counted.step > 0 ? (int)(INT_MIN + offset) : (int)(INT_MAX + offset);
+        Operand representable = Operand::variable(cfg->create_new_tempvar(INT));
+        guard->instrs->push_back(cfg->create_instr(guard, counted.step > 0 ? cmp_ge : cmp_le, {representable, bound, Operand::immediate(safe)}));
+        guard->test_var_index = representable.get_index();
+        check = cfg->create_bb(cfg->new_BB_name("unroll_guard"));
+        guard->set_exit_true(check);
+        guard->set_exit_false(header);
+        cfg->add_bb(check);
+        limit = Operand::variable(cfg->create_new_tempvar(INT));
+        check->instrs->push_back(cfg->create_instr(check, add, {limit, bound, Operand::immediate((int)-offset)}));
+    }
+    Operand enough = Operand::variable(cfg->create_new_tempvar(INT));
+    check->instrs->push_back(cfg->create_instr(check, counted.condition, {enough, induction, limit}));
+    check->test_var_index = enough.get_index();
+
+    // la boucle déroulée ne teste qu'à la fin de sa dernière copie, puis le test d'origine décide du reste
+    auto remainder = cfg->create_bb(cfg->new_BB_name("remainder"));
+    BasicBlock *first = nullptr;
+    BasicBlock *previous = nullptr;
+    for (int i = 0; i < copies; i++)
+    {
+        BasicBlock *latch;
+        BasicBlock *copy = copyBody(counted, latch);
+        if (previous == nullptr)
+            first = copy;
+        else
+            previous->set_exit_true(copy);
+        latch->set_exit_false(nullptr);
+        previous = latch;
+    }
+    Operand again = Operand::variable(cfg->create_new_tempvar(INT));
+    previous->instrs->push_back(cfg->create_instr(previous, counted.condition, {again, induction, limit}));
+    previous->test_var_index = again.get_index();
+    previous->set_exit_true(first);
+    previous->set_exit_false(remainder);
+    check->set_exit_true(first);
+    check->set_exit_false(header);
+
+    Operand more = Operand::variable(cfg->create_new_tempvar(INT));
+    remainder->instrs->push_back(cfg->create_instr(remainder, counted.condition, {more, induction, bound}));
+    remainder->test_var_index = more.get_index();
+    remainder->set_exit_true(header);
+    remainder->set_exit_false(counted.exit);
+    cfg->add_bb(remainder);
+    return true;
+}
+
+void LoopUnroller::redirectEntries(const CountedLoop &counted, BasicBlock *target)
+{
+    BasicBlock *header = counted.loop->header;
+    vector<BasicBlock *> entries;
+    for (auto pred : *header->predecessors)
+        if (!counted.loop->contains(pred) && find(entries.begin(), entries.end(), pred) == entries.end())
+            entries.push_back(pred);
+    for (auto pred : entries)
+    {
+        if (pred->exit_true == header)
+            pred->set_exit_true(target);
+        if (pred->exit_false == header)
+            pred->set_exit_false(target);
+    }
+}
+
+void LoopUnroller::remark(const Loop *loop, const string &message) const
+{
+    if (remarks != nullptr)
+        *remarks << "remark: " << cfg->cfg_name << ": loop " << loop->header->label << ": " << message << "\n";
+}
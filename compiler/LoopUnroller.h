@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CFG.h"
+#include "DominatorTree.h"
+#include "LoopNest.h"
+
+using namespace std;
+
+/** Unrolling of the counted loops of a CFG, out of SSA form
+
+   A counted loop is an innermost loop whose only exit is the conditional branch of its only latch,
+   the shape of the loops once rotated (see IROptimizer::rotateLoops), testing i < n, i <= n, i > n
+   or i >= n where:
+     - the induction variable i is written once in the loop, by incr, decr, or an add or sub of an
+       immediate (the step, towards the bound), in a block that dominates the latch or in the latch
+       before the test: once per iteration (the for_after block of a for loop, merged into the latch);
+     - the bound n is an immediate or a variable that the loop does not write.
+   Each iteration runs the body from the header to the latch exactly once.
+
+   When i enters the loop with a constant value and n is an immediate, the trip count is known: if
+   it is at most maxFullUnrollTrips and the copies of the body fit in maxUnrolledSize instructions,
+   the loop is replaced by one copy of the body per iteration, chained without any test.
+   Otherwise the body is copied factor times (fewer if the copies would not fit) in a new loop that
+   only tests at its last copy, against n - (factor - 1) * step: while this test holds, the tests
+   of the other copies hold too. A guard before it goes to the original loop, which becomes the
+   remainder loop, when there are fewer than factor iterations left (or when n - (factor - 1) * step
+   would overflow); at its end, the original test decides whether the remainder loop runs.
+
+   Each loop examined gets a remark, unrolled or why not. The copies leave dead comparisons and an
+   unreachable loop behind, for dce and simplify-cfg.
+*/
+class LoopUnroller
+{
+public:
+    LoopUnroller(CFG *cfg, const DominatorTree &tree, int factor, ostream *remarks = nullptr);
+    int unroll(const LoopNest &loops, const function<bool()> &stop = nullptr); /**< number of loops unrolled, the others are left when stop() returns true */
+
+    static const unsigned long maxUnrolledSize = 64; /**< instructions of all the copies of the body of a loop */
+    static const int maxFullUnrollTrips = 16; /**< iterations of a loop beyond which it is never fully unrolled */
+
+protected:
+    struct CountedLoop
+    {
+        Loop *loop;
+        BasicBlock *latch;
+        BasicBlock *exit; /**< successor of the latch out of the loop */
+        int induction;
+        long long step;
+        Operation condition; /**< cmp_lt, cmp_le, cmp_gt or cmp_ge: the loop goes on while (induction condition bound) */
+        Operand bound;
+        unsigned long size; /**< instructions of the body */
+    };
+
+    bool analyze(Loop *loop, CountedLoop &counted, string &reason) const; /**< false, with the reason, if the loop is not counted */
+    bool tripCount(const CountedLoop &counted, int &trips) const; /**< false if unknown or beyond maxFullUnrollTrips */
+    BasicBlock *copyBody(const CountedLoop &counted, BasicBlock *&latch); /**< header of a copy of the blocks of the loop, whose latch loops back to it */
+    void fullyUnroll(const CountedLoop &counted, int trips);
+    bool unrollWithRemainder(const CountedLoop &counted, int copies, string &reason);
+    void redirectEntries(const CountedLoop &counted, BasicBlock *target); /**< the edges entering the loop go to target instead */
+    void remark(const Loop *loop, const string &message) const;
+
+    CFG *cfg;
+    const DominatorTree &tree;
+    int factor;
+    ostream *remarks;
+};
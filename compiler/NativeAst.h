@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string_view>
+
+#include "Arena.h"
+#include "Operation.h"
+#include "Type.h"
+
+using namespace std;
+
+/** Syntax tree built by the NativeParser (--frontend=native)
+
+   A compact tree allocated in the arena of the compilation unit: names are views into the
+   source text, nothing is copied, and variables also carry their interned identifier. It only exists because CToIRVisitor does not generate the
+   IR in source order (the 'after' part of a for loop comes after its body, a temporary is
+   created before the operands of its operation), and the native front end must produce the
+   same IR to be interchangeable with ANTLR.
+*/
+
+struct AstExpression {
+    enum Kind : unsigned char {
+        PARENS,      /**< ( left ) */
+        POSTFIX,     /**< name++ or name-- (operation incr or decr) */
+        PREFIX,      /**< ++name or --name */
+        UNARY,       /**< + - ! ~ left (operation copyvar, neg, lnot or bwnot) */
+        BINARY,      /**< left operation right */
+        LAND,        /**< left && right */
+        LOR,         /**< left || right */
+        CONDITIONAL, /**< left ? right : third */
+        CALL,        /**< name(arguments) */
+        AFFECTATION, /**< name = left, or name op= left (operation copyvar or the op) */
+        VARIABLE,    /**< name */
+        CONSTANT     /**< value (an integer literal or a character) */
+    };
+
+    Kind kind;
+    Operation operation = copyvar;
+    string_view name;
+    int identifier = -1; /**< interned name */
+    string_view text; /**< text of a CONSTANT, converted during the IR generation like CToIRVisitor does */
+    AstExpression *left = nullptr;
+    AstExpression *right = nullptr;
+    AstExpression *third = nullptr;
+    ArenaVector<AstExpression *> *arguments = nullptr;
+};
+
+struct AstDeclaration {
+    string_view name;
+    int identifier;
+    AstExpression *value; /**< nullptr for int x; */
+};
+
+struct AstStatement {
+    enum Kind : unsigned char {
+        EMPTY,
+        EXPRESSION,
+        DECLARATIONS,
+        RETURN,
+        BREAK,
+        CONTINUE,
+        IF,       /**< if (expression) body else elseBody */
+        WHILE,    /**< while (expression) body */
+        DO_WHILE, /**< do body while (expression) */
+        FOR,      /**< for (init; expression; after) body, each part is optional */
+        BLOC
+    };
+
+    Kind kind;
+    AstExpression *expression = nullptr;
+    AstStatement *body = nullptr;
+    AstStatement *elseBody = nullptr;
+    AstStatement *init = nullptr; /**< EXPRESSION or DECLARATIONS statement */
+    AstExpression *after = nullptr;
+    ArenaVector<AstStatement *> *statements = nullptr;     /**< BLOC */
+    ArenaVector<AstDeclaration> *declarations = nullptr; /**< DECLARATIONS */
+};
+
+struct AstFunction {
+    Type type;
+    string_view name;
+    int identifier; /**< interned name */
+    ArenaVector<int> *params; /**< interned names */
+    AstStatement *body; /**< a BLOC */
+};
+
+struct AstProgram {
+    ArenaVector<AstFunction *> *functions;
+};
@@ -0,0 +1,406 @@
+#include "NativeIRBuilder.h"
+
+#include "CompileError.h"
+
+NativeIRBuilder::NativeIRBuilder(Arena *arena, Identifiers *identifiers, ostream &diagnostics) :
+    checker(arena, identifiers, diagnostics)
+{
+    cfgs = new vector<CFG *>();
+}
+
+vector<CFG *> *NativeIRBuilder::build(const AstProgram *program)
+{
+    // les en-têtes de toutes les fonctions sont connus d'avance : un appel à une fonction définie plus loin n'est pas un @PLT
+    for (const AstFunction *function : *program->functions)
+    {
+        checker.add_function(function->identifier, function->type, function->params->size());
+    }
+
+    for (const AstFunction *function : *program->functions)
+    {
+        this->function(function);
+    }
+
+    checker.check_main();
+    return cfgs;
+}
+
+void NativeIRBuilder::checkVoidCall(const AstExpression *expression) const
+{
+    if (expression != nullptr && expression->kind == AstExpression::CALL)
+        checker.check_void_call(expression->identifier);
+}
+
+void NativeIRBuilder::function(const AstFunction *function)
+{
+    cfg = checker.begin_function(function->identifier);
+    cfgs->push_back(cfg);
+
+    for (unsigned long i = 0; i < function->params->size(); i++)
+    {
+        checker.add_param((*function->params)[i], i);
+    }
+
+    statement(function->body);
+}
+
+void NativeIRBuilder::declaration(const AstDeclaration &declaration)
+{
+    checkVoidCall(declaration.value);
+    Operand variableIndex = checker.declare_variable(declaration.identifier);
+
+    if (declaration.value != nullptr)
+    {
+        Operand valueIndex = expression(declaration.value);
+        checker.initialize_variable(declaration.identifier);
+        cfg->current_bb->add_IRInstr(copyvar, {variableIndex, valueIndex});
+    }
+}
+
+void NativeIRBuilder::statement(const AstStatement *statement)
+{
+    switch (statement->kind)
+    {
+    case AstStatement::EMPTY:
+        break;
+    case AstStatement::EXPRESSION:
+        expression(statement->expression);
+        break;
+    case AstStatement::DECLARATIONS:
+        for (const AstDeclaration &declaration : *statement->declarations)
+            this->declaration(declaration);
+        break;
+    case AstStatement::RETURN:
+    {
+        checkVoidCall(statement->expression);
+        Operand variableIndex = expression(statement->expression);
+        cfg->current_bb->add_IRInstr(ret, {variableIndex});
+        break;
+    }
+    case AstStatement::BREAK:
+    case AstStatement::CONTINUE:
+    {
+        bool isBreak = statement->kind == AstStatement::BREAK;
+        if (loops.empty())
+        {
+            throw CompileError(3, string("Instruction ") + (isBreak ? "break" : "continue") + " utilisée dans un contexte invalide");
+        }
+        cfg->current_bb->add_IRInstr(jump, {Operand::label(isBreak ? loops.top().second : loops.top().first)});
+        break;
+    }
+    case AstStatement::BLOC:
+        cfg->add_symbol_context();
+        for (const AstStatement *child : *statement->statements)
+            this->statement(child);
+        checker.end_symbol_context();
+        break;
+    case AstStatement::IF:
+    {
+        checkVoidCall(statement->expression);
+        Operand variableIndex = expression(statement->expression);
+        cfg->current_bb->test_var_index = to_variable(variableIndex);
+
+        auto *bbIf = cfg->current_bb;
+        auto *bbTrue = cfg->create_bb(cfg->new_BB_name("if_true"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("if_out"));
+        bbIf->set_exit_true(bbTrue);
+
+        cfg->add_bb(bbTrue);
+        cfg->current_bb = bbTrue;
+        this->statement(statement->body);
+        cfg->current_bb->set_exit_true(bbOut);
+
+        if (statement->elseBody == nullptr)
+        {
+            bbIf->set_exit_false(bbOut);
+        }
+        else
+        {
+            auto *bbFalse = cfg->create_bb(cfg->new_BB_name("if_false"));
+            bbIf->set_exit_false(bbFalse);
+
+            cfg->add_bb(bbFalse);
+            cfg->current_bb = bbFalse;
+            this->statement(statement->elseBody);
+            cfg->current_bb->set_exit_true(bbOut);
+        }
+        cfg->add_bb(bbOut);
+        cfg->current_bb = bbOut;
+        break;
+    }
+    case AstStatement::WHILE:
+    {
+        checkVoidCall(statement->expression);
+        auto *bbTest = cfg->create_bb(cfg->new_BB_name("while_test"));
+        auto *bbBloc = cfg->create_bb(cfg->new_BB_name("while_bloc"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("while_out"));
+
+        cfg->add_bb(bbTest);
+        cfg->add_bb(bbBloc);
+        cfg->add_bb(bbOut);
+
+        cfg->current_bb->set_exit_true(bbTest);
+        bbTest->set_exit_true(bbBloc);
+        bbTest->set_exit_false(bbOut);
+
+        cfg->current_bb = bbTest;
+        Operand variableIndex = expression(statement->expression);
+        cfg->current_bb->test_var_index = to_variable(variableIndex);
+
+        loops.push(make_pair(bbTest, bbOut));
+        cfg->current_bb = bbBloc;
+        this->statement(statement->body);
+        cfg->current_bb->set_exit_true(bbTest);
+        loops.pop();
+
+        cfg->current_bb = bbOut;
+        break;
+    }
+    case AstStatement::DO_WHILE:
+    {
+        auto *bbTest = cfg->create_bb(cfg->new_BB_name("do_while_test"));
+        auto *bbBloc = cfg->create_bb(cfg->new_BB_name("do_while_bloc"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("do_while_out"));
+
+        cfg->add_bb(bbTest);
+        cfg->add_bb(bbBloc);
+        cfg->add_bb(bbOut);
+
+        cfg->current_bb->set_exit_true(bbBloc);
+        bbTest->set_exit_true(bbBloc);
+        bbTest->set_exit_false(bbOut);
+
+        loops.push(make_pair(bbTest, bbOut));
+        cfg->current_bb = bbBloc;
+        this->statement(statement->body);
+        cfg->current_bb->set_exit_true(bbTest);
+        loops.pop();
+
+        cfg->current_bb = bbTest;
+        Operand variableIndex = expression(statement->expression);
+        cfg->current_bb->test_var_index = to_variable(variableIndex);
+
+        cfg->current_bb = bbOut;
+        break;
+    }
+    case AstStatement::FOR:
+    {
+        cfg->add_symbol_context();
+        if (statement->init != nullptr)
+            this->statement(statement->init);
+
+        auto *bbTest = cfg->create_bb(cfg->new_BB_name("for_test"));
+        auto *bbBloc = cfg->create_bb(cfg->new_BB_name("for_bloc"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("for_out"));
+
+        cfg->add_bb(bbTest);
+        cfg->add_bb(bbBloc);
+        cfg->add_bb(bbOut);
+
+        cfg->current_bb->set_exit_true(bbTest);
+        bbTest->set_exit_true(bbBloc);
+        bbTest->set_exit_false(bbOut);
+
+        cfg->current_bb = bbTest;
+        if (statement->expression != nullptr)
+        {
+            Operand variableIndex = expression(statement->expression);
+            cfg->current_bb->test_var_index = to_variable(variableIndex);
+        }
+        else
+        {
+            bbTest->set_exit_false(nullptr);
+        }
+
+        if (statement->after != nullptr)
+        {
+            auto *bbAfterBloc = cfg->create_bb(cfg->new_BB_name("for_after"));
+            cfg->add_bb(bbAfterBloc);
+
+            loops.push(make_pair(bbAfterBloc, bbOut));
+            cfg->current_bb = bbBloc;
+            this->statement(statement->body);
+            loops.pop();
+
+            cfg->current_bb->set_exit_true(bbAfterBloc);
+            cfg->current_bb = bbAfterBloc;
+            expression(statement->after);
+            cfg->current_bb->set_exit_true(bbTest);
+        }
+        else
+        {
+            loops.push(make_pair(bbTest, bbOut));
+            cfg->current_bb = bbBloc;
+            this->statement(statement->body);
+            loops.pop();
+            cfg->current_bb->set_exit_true(bbTest);
+        }
+        cfg->current_bb = bbOut;
+        checker.end_symbol_context();
+        break;
+    }
+    }
+}
+
+Operand NativeIRBuilder::expression(const AstExpression *expression)
+{
+    switch (expression->kind)
+    {
+    case AstExpression::PARENS:
+        return this->expression(expression->left);
+    case AstExpression::VARIABLE:
+        return checker.use_variable(expression->identifier);
+    case AstExpression::CONSTANT:
+        // les constantes sont des opérandes immédiats, sans variable temporaire
+        if (expression->text[0] == '\'')
+            return Operand::immediate(expression->text[1]);
+        return Operand::immediate((int)stoll(string(expression->text)));
+    case AstExpression::BINARY:
+    {
+        checkVoidCall(expression->left);
+        checkVoidCall(expression->right);
+        Operand variableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+        Operand leftOperandIndex = this->expression(expression->left);
+        Operand rightOperandIndex = this->expression(expression->right);
+        cfg->current_bb->add_IRInstr(expression->operation, {variableIndex, leftOperandIndex, rightOperandIndex});
+        return variableIndex;
+    }
+    case AstExpression::UNARY:
+    {
+        checkVoidCall(expression->left);
+        Operand variableIndex = this->expression(expression->left);
+        Operand tempVariableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+        cfg->current_bb->add_IRInstr(expression->operation, {tempVariableIndex, variableIndex});
+        return tempVariableIndex;
+    }
+    case AstExpression::PREFIX:
+    {
+        Operand variableIndex = checker.use_variable(expression->identifier);
+        Operand tempVariableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+        cfg->current_bb->add_IRInstr(expression->operation, {variableIndex});
+        cfg->current_bb->add_IRInstr(copyvar, {tempVariableIndex, variableIndex});
+        return tempVariableIndex;
+    }
+    case AstExpression::POSTFIX:
+    {
+        Operand variableIndex = checker.use_variable(expression->identifier);
+        Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
+        cfg->current_bb->add_IRInstr(copyvar, {resultIndex, variableIndex});
+        cfg->current_bb->add_IRInstr(expression->operation, {variableIndex});
+        return resultIndex;
+    }
+    case AstExpression::LAND:
+    {
+        checkVoidCall(expression->left);
+        checkVoidCall(expression->right);
+        auto *bbTrueResult = cfg->create_bb(cfg->new_BB_name("land_true_result"));
+        auto *bbTrue = cfg->create_bb(cfg->new_BB_name("land_true"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("land_out"));
+        bbOut->set_exit_true(cfg->current_bb->exit_true);
+        bbOut->set_exit_false(cfg->current_bb->exit_false);
+
+        cfg->add_bb(bbTrueResult);
+        cfg->add_bb(bbTrue);
+        cfg->add_bb(bbOut);
+
+        Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
+
+        cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(0)});
+        Operand leftResultIndex = this->expression(expression->left);
+        cfg->current_bb->test_var_index = to_variable(leftResultIndex);
+        cfg->current_bb->set_exit_true(bbTrue);
+        cfg->current_bb->set_exit_false(bbOut);
+
+        cfg->current_bb = bbTrue;
+        Operand rightResultIndex = this->expression(expression->right);
+        cfg->current_bb->test_var_index = to_variable(rightResultIndex);
+        cfg->current_bb->set_exit_true(bbTrueResult);
+        cfg->current_bb->set_exit_false(bbOut);
+
+        cfg->current_bb = bbTrueResult;
+        cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(1)});
+        cfg->current_bb->set_exit_true(bbOut);
+
+        cfg->current_bb = bbOut;
+        return resultIndex;
+    }
+    case AstExpression::LOR:
+    {
+        checkVoidCall(expression->left);
+        checkVoidCall(expression->right);
+        auto *bbFalse = cfg->create_bb(cfg->new_BB_name("lor_false"));
+        auto *bbTrueResult = cfg->create_bb(cfg->new_BB_name("lor_true_result"));
+        auto *bbOut = cfg->create_bb(cfg->new_BB_name("lor_out"));
+        cfg->add_bb(bbFalse);
+        cfg->add_bb(bbTrueResult);
+        cfg->add_bb(bbOut);
+        bbOut->set_exit_true(cfg->current_bb->exit_true);
+        bbOut->set_exit_false(cfg->current_bb->exit_false);
+
+        Operand resultIndex = Operand::variable(cfg->create_new_tempvar(INT));
+
+        cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(0)});
+        Operand leftResultIndex = this->expression(expression->left);
+        cfg->current_bb->test_var_index = to_variable(leftResultIndex);
+        cfg->current_bb->set_exit_true(bbTrueResult);
+        cfg->current_bb->set_exit_false(bbFalse);
+
+        cfg->current_bb = bbFalse;
+        Operand rightResultIndex = this->expression(expression->right);
+        cfg->current_bb->test_var_index = to_variable(rightResultIndex);
+        cfg->current_bb->set_exit_true(bbTrueResult);
+        cfg->current_bb->set_exit_false(bbOut);
+
+        cfg->current_bb = bbTrueResult;
+        cfg->current_bb->add_IRInstr(ldconst, {resultIndex, Operand::immediate(1)});
+        cfg->current_bb->set_exit_true(bbOut);
+
+        cfg->current_bb = bbOut;
+        return resultIndex;
+    }
+    case AstExpression::CONDITIONAL:
+        // CToIRVisitor n'a pas de visite pour le ternaire : visitChildren évalue les trois opérandes et renvoie le dernier
+        this->expression(expression->left);
+        this->expression(expression->right);
+        return this->expression(expression->third);
+    case AstExpression::CALL:
+    {
+        for (const AstExpression *argument : *expression->arguments)
+            checkVoidCall(argument);
+        const FunctionInfo *callee = checker.check_call(expression->identifier, expression->arguments->size());
+        Operand variableIndex = Operand::variable(cfg->create_new_tempvar(INT));
+
+        vector<Operand> params;
+        params.push_back(variableIndex);
+        // une fonction qui n'est pas définie dans le fichier est appelée par la PLT
+        params.push_back(callee != nullptr ? callee->symbol : Operand::function(string(expression->name) + "@PLT"));
+        for (const AstExpression *argument : *expression->arguments)
+        {
+            params.push_back(this->expression(argument));
+        }
+        cfg->current_bb->add_IRInstr(call, params);
+        return variableIndex;
+    }
+    case AstExpression::AFFECTATION:
+    {
+        checkVoidCall(expression->left);
+        Operand variableIndex = checker.assign_variable(expression->identifier);
+        Operand operandVariableIndex = this->expression(expression->left);
+        if (expression->operation == copyvar)
+            cfg->current_bb->add_IRInstr(copyvar, {variableIndex, operandVariableIndex});
+        else
+            cfg->current_bb->add_IRInstr(expression->operation, {variableIndex, variableIndex, operandVariableIndex});
+        return variableIndex;
+    }
+    }
+    throw runtime_error("unknown expression");
+}
+
+int NativeIRBuilder::to_variable(const Operand &operand)
+{
+    if (!operand.is_immediate())
+        return operand.get_index();
+    int variableIndex = cfg->create_new_tempvar(INT);
+    cfg->current_bb->add_IRInstr(ldconst, {Operand::variable(variableIndex), operand});
+    return variableIndex;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ostream>
+#include <stack>
+#include <vector>
+
+#include "Arena.h"
+#include "CFG.h"
+#include "Identifiers.h"
+#include "NativeAst.h"
+#include "SemanticChecker.h"
+
+using namespace std;
+
+/** Generates the IR of the syntax tree of the NativeParser (--frontend=native)
+
+   Same walk as CToIRVisitor: each construct is checked by the SemanticChecker in the same order, and
+   translated into the same instructions, temporaries and basic blocks. Its output, errors and
+   warnings are thus the same as with ANTLR.
+*/
+class NativeIRBuilder {
+public:
+    NativeIRBuilder(Arena *arena, Identifiers *identifiers, ostream &diagnostics); /**< identifiers: those interned by the NativeParser */
+
+    vector<CFG *> *build(const AstProgram *program); /**< one CFG per function, errors are thrown as CompileError */
+
+protected:
+    SemanticChecker checker;
+    vector<CFG *> *cfgs;
+    CFG *cfg = nullptr;
+    stack<pair<BasicBlock *, BasicBlock *>> loops; /**< first -> continue, second -> break */
+
+    void checkVoidCall(const AstExpression *expression) const; /**< a void function may not be an operand */
+
+    void function(const AstFunction *function);
+    void statement(const AstStatement *statement);
+    void declaration(const AstDeclaration &declaration);
+    Operand expression(const AstExpression *expression);
+    int to_variable(const Operand &operand); /**< index of a variable holding the operand, an immediate is loaded into a new temporary */
+};
@@ -0,0 +1,271 @@
+#include "NativeLexer.h"
+
+#include <algorithm>
+#include <cctype>
+
+NativeLexer::NativeLexer(const string &source, Identifiers *identifiers, ostream &diagnostics) :
+    source(source), identifiers(identifiers), diagnostics(diagnostics) {}
+
+vector<Token> NativeLexer::tokenize() {
+    vector<Token> tokens;
+    tokens.reserve(source.size() / 4 + 1);
+    while (position < source.size()) {
+        char c = source[position];
+        size_t start = position;
+        unsigned startLine = line;
+        unsigned startColumn = column;
+        Token::Kind kind;
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            advance(1);
+            continue;
+        }
+        if (source.compare(position, 2, "/*") == 0) {
+            size_t end = source.find("*/", position + 2);
+            if (end != string::npos) {
+                advance(end + 2 - position);
+                continue;
+            }
+            // commentaire non terminé : comme ANTLR, on retombe sur le plus long préfixe reconnu, '/'
+        }
+        if (c == '#') {
+            size_t end = source.find('\n', position);
+            if (end == string::npos) {
+                // la directive doit finir par un retour à la ligne : ANTLR abandonne tout le reste du fichier
+                recognitionError(start, startLine, startColumn, source.size());
+                advance(source.size() - position);
+                break;
+            }
+            advance(end + 1 - position);
+            continue;
+        }
+
+        if (isdigit((unsigned char)c)) {
+            size_t end = position;
+            while (end < source.size() && isdigit((unsigned char)source[end]))
+                end++;
+            kind = Token::CONST;
+            advance(end - position);
+        } else if (isalpha((unsigned char)c) || c == '_') {
+            size_t end = position;
+            while (end < source.size() && (isalnum((unsigned char)source[end]) || source[end] == '_'))
+                end++;
+            kind = keyword(string_view(source).substr(position, end - position));
+            advance(end - position);
+        } else if (c == '\'') {
+            // CONSTCHAR : '\'' [ -~] '\''
+            bool printable = position + 1 < source.size() && source[position + 1] >= ' ' && source[position + 1] <= '~';
+            if (printable && position + 2 < source.size() && source[position + 2] == '\'') {
+                kind = Token::CONSTCHAR;
+                advance(3);
+            } else {
+                // ANTLR affiche ce qu'il a lu jusqu'au caractère qui le bloque inclus, et passe ce caractère
+                size_t end = position + 1;
+                if (printable)
+                    end++;
+                if (end < source.size())
+                    end += characterSize(end);
+                recognitionError(start, startLine, startColumn, end);
+                advance(end - position);
+                continue;
+            }
+        } else {
+            size_t length;
+            kind = punctuation(length);
+            if (kind == Token::END) {
+                size_t end = position + characterSize(position);
+                recognitionError(start, startLine, startColumn, end);
+                advance(end - position);
+                continue;
+            }
+            advance(length);
+        }
+        tokens.push_back({kind, startLine, startColumn, (unsigned)start, (unsigned)(position - start)});
+        if (kind == Token::ID)
+            tokens.back().identifier = identifiers->intern(string_view(source).substr(start, position - start));
+    }
+    tokens.push_back({Token::END, line, column, (unsigned)source.size(), 0});
+    return tokens;
+}
+
+void NativeLexer::advance(size_t count) {
+    for (size_t end = position + count; position < end; position++) {
+        if (source[position] == '\n') {
+            line++;
+            column = 0;
+        } else if (((unsigned char)source[position] & 0xC0) != 0x80) {
+            // les octets de continuation UTF-8 ne sont pas des caractères
+            column++;
+        }
+    }
+}
+
+size_t NativeLexer::characterSize(size_t at) const {
+    unsigned char c = source[at];
+    size_t size = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    return min(size, source.size() - at);
+}
+
+void NativeLexer::recognitionError(size_t start, unsigned startLine, unsigned startColumn, size_t end) {
+    string text;
+    for (size_t i = start; i < end; i++) {
+        switch (source[i]) {
+        case '\n':
+            text += "\\n";
+            break;
+        case '\t':
+            text += "\\t";
+            break;
+        case '\r':
+            text += "\\r";
+            break;
+        default:
+            text += source[i];
+        }
+    }
+    diagnostics << "line " << startLine << ":" << startColumn << " token recognition error at: '" << text << "'" << endl;
+}
+
+Token::Kind NativeLexer::keyword(string_view word) const {
+    switch (word[0]) {
+    case 'b':
+        return word == "break" ? Token::BREAK : Token::ID;
+    case 'c':
+        return word == "continue" ? Token::CONTINUE : Token::ID;
+    case 'd':
+        return word == "do" ? Token::DO : Token::ID;
+    case 'e':
+        return word == "else" ? Token::ELSE : Token::ID;
+    case 'f':
+        return word == "for" ? Token::FOR : Token::ID;
+    case 'i':
+        return word == "int" ? Token::INT : word == "if" ? Token::IF : Token::ID;
+    case 'r':
+        return word == "return" ? Token::RETURN : Token::ID;
+    case 'v':
+        return word == "void" ? Token::VOID : Token::ID;
+    case 'w':
+        return word == "while" ? Token::WHILE : Token::ID;
+    default:
+        return Token::ID;
+    }
+}
+
+Token::Kind NativeLexer::punctuation(size_t &length) const {
+    char c = source[position];
+    char next = position + 1 < source.size() ? source[position + 1] : '\0';
+    char third = position + 2 < source.size() ? source[position + 2] : '\0';
+    length = 2;
+    switch (c) {
+    case '(':
+        length = 1;
+        return Token::LPAREN;
+    case ')':
+        length = 1;
+        return Token::RPAREN;
+    case '{':
+        length = 1;
+        return Token::LBRACE;
+    case '}':
+        length = 1;
+        return Token::RBRACE;
+    case ';':
+        length = 1;
+        return Token::SEMICOLON;
+    case ',':
+        length = 1;
+        return Token::COMMA;
+    case '?':
+        length = 1;
+        return Token::QUESTION;
+    case ':':
+        length = 1;
+        return Token::COLON;
+    case '~':
+        length = 1;
+        return Token::BWNOT;
+    case '+':
+        if (next == '+')
+            return Token::PLUSPLUS;
+        if (next == '=')
+            return Token::PLUSEQ;
+        length = 1;
+        return Token::PLUS;
+    case '-':
+        if (next == '-')
+            return Token::MOINSMOINS;
+        if (next == '=')
+            return Token::MINUSEQ;
+        length = 1;
+        return Token::MINUS;
+    case '*':
+        if (next == '=')
+            return Token::MULTEQ;
+        length = 1;
+        return Token::MULT;
+    case '/':
+        if (next == '=')
+            return Token::DIVEQ;
+        length = 1;
+        return Token::DIV;
+    case '%':
+        if (next == '=')
+            return Token::MODEQ;
+        length = 1;
+        return Token::MOD;
+    case '&':
+        if (next == '&')
+            return Token::LAZYAND;
+        if (next == '=')
+            return Token::BWANDEQ;
+        length = 1;
+        return Token::BWAND;
+    case '|':
+        if (next == '|')
+            return Token::LAZYOR;
+        if (next == '=')
+            return Token::BWOREQ;
+        length = 1;
+        return Token::BWOR;
+    case '^':
+        if (next == '=')
+            return Token::BWXOREQ;
+        length = 1;
+        return Token::BWXOR;
+    case '<':
+        if (next == '<' && third == '=') {
+            length = 3;
+            return Token::BWSLEQ;
+        }
+        if (next == '<')
+            return Token::BWSL;
+        if (next == '=')
+            return Token::LE;
+        length = 1;
+        return Token::LT;
+    case '>':
+        if (next == '>' && third == '=') {
+            length = 3;
+            return Token::BWSREQ;
+        }
+        if (next == '>')
+            return Token::BWSR;
+        if (next == '=')
+            return Token::GE;
+        length = 1;
+        return Token::GT;
+    case '=':
+        if (next == '=')
+            return Token::EQEQ;
+        length = 1;
+        return Token::EQ;
+    case '!':
+        if (next == '=')
+            return Token::NEQ;
+        length = 1;
+        return Token::LNOT;
+    default:
+        length = 0;
+        return Token::END;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Identifiers.h"
+
+using namespace std;
+
+/** A token of the native front end: its kind and its position, the text stays in the source */
+struct Token {
+    enum Kind : unsigned char {
+        END, ID, CONST, CONSTCHAR,
+        INT, VOID, IF, ELSE, WHILE, FOR, DO, RETURN, BREAK, CONTINUE,
+        LPAREN, RPAREN, LBRACE, RBRACE, SEMICOLON, COMMA, QUESTION, COLON,
+        PLUS, MINUS, MULT, DIV, MOD, BWAND, BWOR, BWXOR, BWSL, BWSR, LAZYAND, LAZYOR,
+        GT, LT, GE, LE, EQEQ, NEQ, EQ, MINUSEQ, PLUSEQ, MULTEQ, DIVEQ, MODEQ,
+        BWANDEQ, BWOREQ, BWXOREQ, BWSLEQ, BWSREQ, LNOT, BWNOT, PLUSPLUS, MOINSMOINS
+    };
+
+    Kind kind;
+    unsigned line;
+    unsigned column;
+    unsigned offset; /**< position of the text in the source */
+    unsigned length;
+    int identifier = -1; /**< interned name of an ID */
+};
+
+/** Hand-written lexer for the tokens of ifcc.g4 (--frontend=native)
+
+   Follows the ANTLR lexer generated from the grammar: longest match, keywords before ID,
+   comments and preprocessor lines skipped. A character that starts no token is reported
+   with the same message as ANTLR ("line 1:4 token recognition error at: '@'") and skipped.
+*/
+class NativeLexer {
+public:
+    NativeLexer(const string &source, Identifiers *identifiers, ostream &diagnostics); /**< the names of the IDs are interned in identifiers */
+
+    vector<Token> tokenize(); /**< all the tokens of the source, the last one being END */
+
+protected:
+    const string &source;
+    Identifiers *identifiers;
+    ostream &diagnostics;
+    size_t position = 0;
+    unsigned line = 1;
+    unsigned column = 0;
+
+    void advance(size_t count); /**< skips count bytes, counting lines and columns */
+    size_t characterSize(size_t at) const; /**< bytes of the UTF-8 character at this position */
+    void recognitionError(size_t start, unsigned startLine, unsigned startColumn, size_t end);
+    Token::Kind keyword(string_view word) const;
+    Token::Kind punctuation(size_t &length) const; /**< longest operator at the position, END if none */
+};
@@ -0,0 +1,427 @@
+#include "NativeParser.h"
+
+#include "CompileError.h"
+
+NativeParser::NativeParser(const string &source, Arena *arena, Identifiers *identifiers, ostream &diagnostics) :
+    source(source), arena(arena), identifiers(identifiers), diagnostics(diagnostics) {}
+
+AstProgram *NativeParser::parse() {
+    tokens = NativeLexer(source, identifiers, diagnostics).tokenize();
+    position = 0;
+
+    auto program = arena->create<AstProgram>();
+    program->functions = newVector<AstFunction *>();
+    // prog : function+ ;
+    do {
+        program->functions->push_back(function());
+    } while (!is(Token::END));
+    return program;
+}
+
+const Token &NativeParser::peek(size_t offset) const {
+    return tokens[min(position + offset, tokens.size() - 1)];
+}
+
+const Token &NativeParser::expect(Token::Kind kind) {
+    if (!is(kind))
+        syntaxError();
+    return tokens[position++];
+}
+
+string_view NativeParser::text(const Token &token) const {
+    return string_view(source).substr(token.offset, token.length);
+}
+
+void NativeParser::syntaxError() const {
+    const Token &token = peek();
+    diagnostics << "line " << token.line << ":" << token.column << " syntax error at '"
+                << (token.kind == Token::END ? "<EOF>" : string(text(token))) << "'" << endl;
+    throw CompileError(1, "error: syntax error during parsing");
+}
+
+AstFunction *NativeParser::function() {
+    auto function = arena->create<AstFunction>();
+    if (is(Token::INT))
+        function->type = INT;
+    else if (is(Token::VOID))
+        function->type = VOID;
+    else
+        syntaxError();
+    position++;
+    const Token &name = expect(Token::ID);
+    function->name = text(name);
+    function->identifier = name.identifier;
+    function->params = newVector<int>();
+    expect(Token::LPAREN);
+    if (!is(Token::RPAREN)) {
+        expect(Token::INT);
+        function->params->push_back(expect(Token::ID).identifier);
+        while (is(Token::COMMA)) {
+            position++;
+            expect(Token::INT);
+            function->params->push_back(expect(Token::ID).identifier);
+        }
+    }
+    expect(Token::RPAREN);
+    function->body = bloc();
+    return function;
+}
+
+AstStatement *NativeParser::bloc() {
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::BLOC;
+    statement->statements = newVector<AstStatement *>();
+    expect(Token::LBRACE);
+    while (!is(Token::RBRACE)) {
+        if (is(Token::END))
+            syntaxError();
+        statement->statements->push_back(instruction(true));
+    }
+    position++;
+    return statement;
+}
+
+AstStatement *NativeParser::instruction(bool allowDeclarations) {
+    switch (peek().kind) {
+    case Token::IF:
+        return ifelse();
+    case Token::WHILE:
+        return whileLoop();
+    case Token::FOR:
+        return forLoop();
+    case Token::LBRACE:
+        return bloc();
+    default:
+        break;
+    }
+
+    AstStatement *statement;
+    switch (peek().kind) {
+    case Token::SEMICOLON:
+        statement = arena->create<AstStatement>();
+        statement->kind = AstStatement::EMPTY;
+        break;
+    case Token::RETURN:
+        position++;
+        statement = arena->create<AstStatement>();
+        statement->kind = AstStatement::RETURN;
+        statement->expression = expression();
+        break;
+    case Token::BREAK:
+    case Token::CONTINUE:
+        statement = arena->create<AstStatement>();
+        statement->kind = is(Token::BREAK) ? AstStatement::BREAK : AstStatement::CONTINUE;
+        position++;
+        break;
+    case Token::DO:
+        statement = doWhileLoop();
+        break;
+    case Token::INT:
+        if (!allowDeclarations)
+            syntaxError();
+        statement = declarations();
+        break;
+    default:
+        statement = arena->create<AstStatement>();
+        statement->kind = AstStatement::EXPRESSION;
+        statement->expression = expression();
+    }
+    expect(Token::SEMICOLON);
+    return statement;
+}
+
+AstStatement *NativeParser::declarations() {
+    // declarations : 'int' (declaration? (',' declaration)*) ; "int ;" et "int , x;" sont donc acceptés
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::DECLARATIONS;
+    statement->declarations = newVector<AstDeclaration>();
+    expect(Token::INT);
+    if (is(Token::ID))
+        statement->declarations->push_back(declaration());
+    while (is(Token::COMMA)) {
+        position++;
+        statement->declarations->push_back(declaration());
+    }
+    return statement;
+}
+
+AstDeclaration NativeParser::declaration() {
+    const Token &name = expect(Token::ID);
+    AstDeclaration declaration = {text(name), name.identifier, nullptr};
+    if (is(Token::EQ)) {
+        position++;
+        declaration.value = expression();
+    }
+    return declaration;
+}
+
+AstStatement *NativeParser::ifelse() {
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::IF;
+    expect(Token::IF);
+    expect(Token::LPAREN);
+    statement->expression = expression();
+    expect(Token::RPAREN);
+    statement->body = instruction(false);
+    if (is(Token::ELSE)) {
+        position++;
+        statement->elseBody = instruction(false);
+    }
+    return statement;
+}
+
+AstStatement *NativeParser::whileLoop() {
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::WHILE;
+    expect(Token::WHILE);
+    expect(Token::LPAREN);
+    statement->expression = expression();
+    expect(Token::RPAREN);
+    statement->body = instruction(false);
+    return statement;
+}
+
+AstStatement *NativeParser::doWhileLoop() {
+    // le ';' final est celui de l'instruction qui contient la boucle
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::DO_WHILE;
+    expect(Token::DO);
+    statement->body = instruction(false);
+    expect(Token::WHILE);
+    expect(Token::LPAREN);
+    statement->expression = expression();
+    expect(Token::RPAREN);
+    return statement;
+}
+
+AstStatement *NativeParser::forLoop() {
+    auto statement = arena->create<AstStatement>();
+    statement->kind = AstStatement::FOR;
+    expect(Token::FOR);
+    expect(Token::LPAREN);
+    if (is(Token::INT)) {
+        statement->init = declarations();
+    } else if (!is(Token::SEMICOLON)) {
+        statement->init = arena->create<AstStatement>();
+        statement->init->kind = AstStatement::EXPRESSION;
+        statement->init->expression = expression();
+    }
+    expect(Token::SEMICOLON);
+    if (!is(Token::SEMICOLON))
+        statement->expression = expression();
+    expect(Token::SEMICOLON);
+    if (!is(Token::RPAREN))
+        statement->after = expression();
+    expect(Token::RPAREN);
+    statement->body = instruction(false);
+    return statement;
+}
+
+AstExpression *NativeParser::expression(int minimumPrecedence) {
+    AstExpression *left = primary();
+    while (true) {
+        Token::Kind kind = peek().kind;
+        int operatorPrecedence = precedence(kind);
+        if (operatorPrecedence >= minimumPrecedence) {
+            // opérateurs binaires associatifs à gauche : l'opérande droit ne prend que les opérateurs plus prioritaires
+            position++;
+            auto binary = newExpression(kind == Token::LAZYAND ? AstExpression::LAND : kind == Token::LAZYOR ? AstExpression::LOR : AstExpression::BINARY);
+            binary->operation = binaryOperation(kind);
+            binary->left = left;
+            binary->right = expression(operatorPrecedence + 1);
+            left = binary;
+        } else if (kind == Token::QUESTION && minimumPrecedence == 0) {
+            // le ternaire est le moins prioritaire et, comme dans la grammaire, associatif à gauche
+            position++;
+            auto conditional = newExpression(AstExpression::CONDITIONAL);
+            conditional->left = left;
+            conditional->right = expression();
+            expect(Token::COLON);
+            conditional->third = expression(1);
+            left = conditional;
+        } else {
+            return left;
+        }
+    }
+}
+
+AstExpression *NativeParser::primary() {
+    const Token &token = peek();
+    AstExpression *expression;
+    switch (token.kind) {
+    case Token::LPAREN:
+        position++;
+        expression = newExpression(AstExpression::PARENS);
+        expression->left = this->expression();
+        expect(Token::RPAREN);
+        return expression;
+    case Token::PLUSPLUS:
+    case Token::MOINSMOINS:
+        position++;
+        expression = newExpression(AstExpression::PREFIX);
+        expression->operation = token.kind == Token::PLUSPLUS ? incr : decr;
+        expression->name = text(peek());
+        expression->identifier = expect(Token::ID).identifier;
+        return expression;
+    case Token::PLUS:
+    case Token::MINUS:
+    case Token::LNOT:
+    case Token::BWNOT:
+        // l'opérande d'un opérateur unaire ne contient aucun opérateur binaire
+        position++;
+        expression = newExpression(AstExpression::UNARY);
+        expression->operation = token.kind == Token::PLUS ? copyvar : token.kind == Token::MINUS ? neg : token.kind == Token::LNOT ? lnot : bwnot;
+        expression->left = primary();
+        return expression;
+    case Token::CONST:
+    case Token::CONSTCHAR:
+        position++;
+        expression = newExpression(AstExpression::CONSTANT);
+        expression->text = text(token);
+        return expression;
+    case Token::ID:
+        break;
+    default:
+        syntaxError();
+    }
+
+    position++;
+    Token::Kind next = peek().kind;
+    if (next == Token::PLUSPLUS || next == Token::MOINSMOINS) {
+        position++;
+        expression = newExpression(AstExpression::POSTFIX);
+        expression->operation = next == Token::PLUSPLUS ? incr : decr;
+    } else if (next == Token::LPAREN) {
+        position++;
+        expression = newExpression(AstExpression::CALL);
+        expression->arguments = newVector<AstExpression *>();
+        if (!is(Token::RPAREN)) {
+            expression->arguments->push_back(this->expression());
+            while (is(Token::COMMA)) {
+                position++;
+                expression->arguments->push_back(this->expression());
+            }
+        }
+        expect(Token::RPAREN);
+    } else if (affectationOperation(next) != ldconst) {
+        position++;
+        expression = newExpression(AstExpression::AFFECTATION);
+        expression->operation = affectationOperation(next);
+        expression->left = this->expression();
+    } else {
+        expression = newExpression(AstExpression::VARIABLE);
+    }
+    expression->name = text(token);
+    expression->identifier = token.identifier;
+    return expression;
+}
+
+AstExpression *NativeParser::newExpression(AstExpression::Kind kind) {
+    auto expression = arena->create<AstExpression>();
+    expression->kind = kind;
+    return expression;
+}
+
+int NativeParser::precedence(Token::Kind kind) {
+    switch (kind) {
+    case Token::MULT:
+    case Token::DIV:
+    case Token::MOD:
+        return 10;
+    case Token::PLUS:
+    case Token::MINUS:
+        return 9;
+    case Token::BWSL:
+    case Token::BWSR:
+        return 8;
+    case Token::GT:
+    case Token::LT:
+    case Token::GE:
+    case Token::LE:
+        return 7;
+    case Token::EQEQ:
+    case Token::NEQ:
+        return 6;
+    case Token::BWAND:
+        return 5;
+    case Token::BWXOR:
+        return 4;
+    case Token::BWOR:
+        return 3;
+    case Token::LAZYAND:
+        return 2;
+    case Token::LAZYOR:
+        return 1;
+    default:
+        return -1;
+    }
+}
+
+Operation NativeParser::binaryOperation(Token::Kind kind) {
+    switch (kind) {
+    case Token::MULT:
+        return mul;
+    case Token::DIV:
+        return divide;
+    case Token::MOD:
+        return modulo;
+    case Token::PLUS:
+        return add;
+    case Token::MINUS:
+        return sub;
+    case Token::BWSL:
+        return bwsl;
+    case Token::BWSR:
+        return bwsr;
+    case Token::GT:
+        return cmp_gt;
+    case Token::LT:
+        return cmp_lt;
+    case Token::GE:
+        return cmp_ge;
+    case Token::LE:
+        return cmp_le;
+    case Token::EQEQ:
+        return cmp_eq;
+    case Token::NEQ:
+        return cmp_ne;
+    case Token::BWAND:
+        return bwand;
+    case Token::BWXOR:
+        return bwxor;
+    case Token::BWOR:
+        return bwor;
+    default:
+        // && et || ne sont pas des opérations de l'IR, ils deviennent des branchements
+        return copyvar;
+    }
+}
+
+Operation NativeParser::affectationOperation(Token::Kind kind) {
+    switch (kind) {
+    case Token::EQ:
+        return copyvar;
+    case Token::PLUSEQ:
+        return add;
+    case Token::MINUSEQ:
+        return sub;
+    case Token::MULTEQ:
+        return mul;
+    case Token::DIVEQ:
+        return divide;
+    case Token::MODEQ:
+        return modulo;
+    case Token::BWANDEQ:
+        return bwand;
+    case Token::BWOREQ:
+        return bwor;
+    case Token::BWXOREQ:
+        return bwxor;
+    case Token::BWSLEQ:
+        return bwsl;
+    case Token::BWSREQ:
+        return bwsr;
+    default:
+        return ldconst;
+    }
+}
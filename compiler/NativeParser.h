@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+#include "NativeAst.h"
+#include "NativeLexer.h"
+
+using namespace std;
+
+/** Hand-written parser for the grammar of ifcc.g4 (--frontend=native)
+
+   Recursive descent for the statements and precedence climbing for the expressions, with the
+   same precedences and associativity as the left-recursive 'expression' rule generated by ANTLR.
+   It accepts exactly the same programs. The syntax tree is allocated in the arena given to
+   the constructor. The first syntax error is reported on diagnostics and ends the parse
+   with a CompileError.
+*/
+class NativeParser {
+public:
+    NativeParser(const string &source, Arena *arena, Identifiers *identifiers, ostream &diagnostics);
+
+    AstProgram *parse();
+
+protected:
+    const string &source;
+    Arena *arena;
+    Identifiers *identifiers;
+    ostream &diagnostics;
+    vector<Token> tokens;
+    size_t position = 0;
+
+    const Token &peek(size_t offset = 0) const;
+    bool is(Token::Kind kind, size_t offset = 0) const { return peek(offset).kind == kind; }
+    const Token &expect(Token::Kind kind); /**< consumes a token of this kind, or stops on a syntax error */
+    string_view text(const Token &token) const;
+    [[noreturn]] void syntaxError() const;
+    template <typename T>
+    ArenaVector<T> *newVector() { return arena->create<ArenaVector<T>>(ArenaAllocator<T>(arena)); }
+
+    AstFunction *function();
+    AstStatement *bloc();
+    AstStatement *instruction(bool allowDeclarations); /**< an instruction of a bloc, or a condition_bloc without declarations */
+    AstStatement *declarations();
+    AstDeclaration declaration();
+    AstStatement *ifelse();
+    AstStatement *whileLoop();
+    AstStatement *doWhileLoop();
+    AstStatement *forLoop();
+    AstExpression *expression(int minimumPrecedence = 0);
+    AstExpression *primary();
+    AstExpression *newExpression(AstExpression::Kind kind);
+
+    static int precedence(Token::Kind kind); /**< of a binary operator, -1 for any other token */
+    static Operation binaryOperation(Token::Kind kind);
+    static Operation affectationOperation(Token::Kind kind); /**< ldconst if the token is not an affectation */
+};
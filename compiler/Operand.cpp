@@ -0,0 +1,60 @@
+#include "Operand.h"
+
+#include <mutex>
+#include <unordered_map>
+
+Operand Operand::variable(int index) {
+    Operand operand;
+    operand.kind = VARIABLE;
+    operand.value = index;
+    return operand;
+}
+
+Operand Operand::immediate(int value) {
+    Operand operand;
+    operand.kind = IMMEDIATE;
+    operand.value = value;
+    return operand;
+}
+
+Operand Operand::label(BasicBlock *bb) {
+    Operand operand;
+    operand.kind = LABEL;
+    operand.block = bb;
+    return operand;
+}
+
+// la table est partagée par les fichiers compilés en parallèle (ifcc --batch)
+static mutex functionNamesMutex;
+
+Operand Operand::function(const string &name) {
+    static unordered_map<string, int> numbers;
+    deque<string> &names = functionNames();
+    lock_guard<mutex> lock(functionNamesMutex);
+    auto it = numbers.find(name);
+    if (it == numbers.end()) {
+        it = numbers.emplace(name, names.size()).first;
+        names.push_back(name);
+    }
+    Operand operand;
+    operand.kind = FUNCTION;
+    operand.value = it->second;
+    return operand;
+}
+
+const string &Operand::get_function_name() const {
+    // les éléments d'une deque ne bougent pas quand elle grandit : la référence reste valide après le verrou
+    lock_guard<mutex> lock(functionNamesMutex);
+    return functionNames()[value];
+}
+
+bool Operand::operator==(const Operand &other) const {
+    if (kind != other.kind)
+        return false;
+    return kind == LABEL ? block == other.block : value == other.value;
+}
+
+deque<string> &Operand::functionNames() {
+    static deque<string> names;
+    return names;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <deque>
+#include <string>
+
+class BasicBlock;
+
+using namespace std;
+
+/** An operand of an IR instruction
+
+   A small tagged union, copied by value:
+     - a variable, identified by its index in the symbol table (its offset from %rbp),
+     - an immediate integer value,
+     - a label, i.e. the basic block it designates (jump targets, phi predecessors),
+     - a function symbol, interned in a table shared by all the CFGs (and guarded by a mutex).
+   None of them owns memory, so building, comparing and rewriting operands never allocates.
+*/
+class Operand {
+public:
+    enum Kind : unsigned char {
+        VARIABLE,
+        IMMEDIATE,
+        LABEL,
+        FUNCTION
+    };
+
+    Operand() : kind(VARIABLE), value(0) {}
+
+    static Operand variable(int index);
+    static Operand immediate(int value);
+    static Operand label(BasicBlock *bb);
+    static Operand function(const string &name); /**< interns the name on first use */
+
+    Kind get_kind() const { return kind; }
+    bool is_variable() const { return kind == VARIABLE; }
+    bool is_immediate() const { return kind == IMMEDIATE; }
+    int get_index() const { return value; } /**< index of a variable */
+    int get_value() const { return value; } /**< value of an immediate */
+    BasicBlock *get_block() const { return block; } /**< basic block of a label */
+    const string &get_function_name() const; /**< name of a function symbol */
+
+    bool operator==(const Operand &other) const;
+    bool operator!=(const Operand &other) const { return !(*this == other); }
+
+protected:
+    Kind kind;
+    union {
+        int value; /**< variable index, immediate value or function symbol number */
+        BasicBlock *block;
+    };
+
+    static deque<string> &functionNames(); /**< interned function symbols, indexed by their number */
+};
@@ -36,6 +36,47 @@ typedef enum
     bwsl    = 26,
     bwsr    = 27,
     ret_cst = 28,
+    phi     = 29,
 } Operation;
 
+/** Comparison that holds for (b, a) when condition holds for (a, b): cmp_lt becomes cmp_gt... Other operations are left as they are */
+inline Operation mirrored(Operation condition)
+{
+    switch (condition)
+    {
+    case cmp_lt:
+        return cmp_gt;
+    case cmp_gt:
+        return cmp_lt;
+    case cmp_le:
+        return cmp_ge;
+    case cmp_ge:
+        return cmp_le;
+    default:
+        return condition;
+    }
+}
+
+/** Comparison that holds when condition does not: cmp_lt becomes cmp_ge... Other operations are left as they are */
+inline Operation negated(Operation condition)
+{
+    switch (condition)
+    {
+    case cmp_eq:
+        return cmp_ne;
+    case cmp_ne:
+        return cmp_eq;
+    case cmp_lt:
+        return cmp_ge;
+    case cmp_ge:
+        return cmp_lt;
+    case cmp_le:
+        return cmp_gt;
+    case cmp_gt:
+        return cmp_le;
+    default:
+        return condition;
+    }
+}
+
 #endif // PLD_COMP_OPERATION_H
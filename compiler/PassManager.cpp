@@ -0,0 +1,171 @@
+#include "PassManager.h"
+
+#include <algorithm>
+#include <iomanip>
+
+Pass Pass::onFunction(string name, function<int(CFG *, PassContext &)> run, bool preservesControlFlow, bool required)
+{
+    Pass pass;
+    pass.name = std::move(name);
+    pass.kind = FUNCTION;
+    pass.runFunction = std::move(run);
+    pass.preservesControlFlow = preservesControlFlow;
+    pass.required = required;
+    return pass;
+}
+
+Pass Pass::onBlock(string name, function<int(BasicBlock *)> run, bool required)
+{
+    Pass pass;
+    pass.name = std::move(name);
+    pass.kind = BLOCK;
+    pass.runBlock = std::move(run);
+    pass.preservesControlFlow = true;
+    pass.required = required;
+    return pass;
+}
+
+PassContext::PassContext(CFG *cfg) : cfg(cfg)
+{
+    changed_all();
+}
+
+const DominatorTree &PassContext::dominators()
+{
+    if (dominatorTree == nullptr)
+        dominatorTree = make_unique<DominatorTree>(cfg);
+    return *dominatorTree;
+}
+
+void PassContext::invalidate_control_flow()
+{
+    dominatorTree.reset();
+}
+
+void PassContext::changed(BasicBlock *bb)
+{
+    changedBlocks.push_back(bb);
+}
+
+void PassContext::changed_all()
+{
+    changedBlocks.insert(changedBlocks.end(), cfg->bbs->begin(), cfg->bbs->end());
+}
+
+vector<BasicBlock *> PassContext::changed_blocks() const
+{
+    auto cursor = cursors.find(running);
+    size_t begin = cursor == cursors.end() ? 0 : cursor->second;
+    vector<BasicBlock *> blocks;
+    if (begin == changedBlocks.size())
+        return blocks;
+    unordered_set<BasicBlock *> live(cfg->bbs->begin(), cfg->bbs->end());
+    unordered_set<BasicBlock *> visited;
+    for (size_t i = begin; i < changedBlocks.size(); i++)
+    {
+        BasicBlock *bb = changedBlocks[i];
+        if (live.count(bb) != 0 && visited.insert(bb).second)
+            blocks.push_back(bb);
+    }
+    return blocks;
+}
+
+bool PassContext::out_of_time() const
+{
+    return chrono::steady_clock::now() > deadline;
+}
+
+PassManager::PassManager(vector<PipelineStep> pipeline, chrono::milliseconds budget, PassSettings settings) :
+    pipeline(std::move(pipeline)), budget(budget), settings(settings)
+{
+    for (const PipelineStep &step : this->pipeline)
+        for (const Pass *pass : step.passes)
+            if (find(order.begin(), order.end(), pass) == order.end())
+                order.push_back(pass);
+}
+
+void PassManager::run(CFG *cfg, ostream *remarks)
+{
+    PassContext context(cfg);
+    context.settings = settings;
+    context.remarks = remarks;
+    map<const Pass *, Statistics> statistics;
+    for (const PipelineStep &step : pipeline)
+    {
+        if (!step.repeat)
+        {
+            for (const Pass *pass : step.passes)
+                runPass(pass, cfg, context, statistics);
+            continue;
+        }
+        // une passe qui change quelque chose renvoie au début du groupe : les précédentes voient ses changements
+        int restarts = 0;
+        size_t i = 0;
+        while (i < step.passes.size())
+        {
+            bool changed = runPass(step.passes[i], cfg, context, statistics);
+            i = changed && restarts++ < maxRestarts ? 0 : i + 1;
+        }
+    }
+
+    lock_guard<mutex> lock(totalsMutex);
+    for (auto &entry : statistics)
+    {
+        Statistics &total = totals[entry.first];
+        total.runs += entry.second.runs;
+        total.changes += entry.second.changes;
+        total.overBudget += entry.second.overBudget;
+        total.time += entry.second.time;
+    }
+}
+
+bool PassManager::runPass(const Pass *pass, CFG *cfg, PassContext &context, map<const Pass *, Statistics> &statistics) const
+{
+    Statistics &stats = statistics[pass];
+    bool limited = !pass->required && budget.count() > 0;
+    if (limited && stats.time >= budget)
+        return false;
+
+    auto start = chrono::steady_clock::now();
+    context.deadline = limited ? start + (budget - stats.time) : chrono::steady_clock::time_point::max();
+    context.running = pass;
+    int changes = 0;
+    if (pass->kind == Pass::FUNCTION)
+        changes = pass->runFunction(cfg, context);
+    else
+        // seuls les blocs modifiés depuis le dernier passage
+        for (BasicBlock *bb : context.changed_blocks())
+        {
+            int blockChanges = pass->runBlock(bb);
+            if (blockChanges != 0)
+                context.changed(bb);
+            changes += blockChanges;
+        }
+    // la passe a déjà vu les blocs qu'elle vient de modifier
+    context.cursors[pass] = context.changedBlocks.size();
+    auto elapsed = chrono::steady_clock::now() - start;
+
+    stats.runs++;
+    stats.changes += changes;
+    stats.time += elapsed;
+    if (limited && stats.time >= budget)
+        stats.overBudget++;
+    if (changes != 0 && !pass->preservesControlFlow)
+        context.invalidate_control_flow();
+    return changes != 0;
+}
+
+void PassManager::report(ostream &o) const
+{
+    lock_guard<mutex> lock(totalsMutex);
+    o << left << setw(20) << "pass" << right << setw(8) << "runs" << setw(10) << "changes" << setw(12) << "time (ms)"
+      << setw(13) << "over budget" << "\n";
+    for (const Pass *pass : order)
+    {
+        auto it = totals.find(pass);
+        Statistics stats = it == totals.end() ? Statistics() : it->second;
+        o << left << setw(20) << pass->name << right << setw(8) << stats.runs << setw(10) << stats.changes
+          << setw(12) << fixed << setprecision(3) << chrono::duration<double, milli>(stats.time).count()
+          << setw(13) << stats.overBudget << "\n";
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "CFG.h"
+#include "DominatorTree.h"
+#include "SSA.h"
+
+using namespace std;
+
+class PassContext;
+
+/** A named optimization pass
+
+   run() transforms one function, or one block for a BLOCK pass, and returns the number of changes it
+   made (0 when the function is left as it was). A pass that rewires the blocks says so with
+   preservesControlFlow = false: the analyses of the control flow cached in the PassContext are then
+   dropped. A required pass lowers the IR for gen_asm: it always runs, whatever its time budget.
+*/
+struct Pass
+{
+    enum Kind
+    {
+        FUNCTION,
+        BLOCK
+    };
+
+    string name;
+    Kind kind;
+    function<int(CFG *, PassContext &)> runFunction;
+    function<int(BasicBlock *)> runBlock;
+    bool preservesControlFlow = false;
+    bool required = false;
+
+    static Pass onFunction(string name, function<int(CFG *, PassContext &)> run, bool preservesControlFlow, bool required = false);
+    static Pass onBlock(string name, function<int(BasicBlock *)> run, bool required = false); /**< block passes never change the control flow */
+};
+
+/** A step of a pipeline: passes run once in order, or a group repeated until none of them changes anything
+
+   In a repeated group, a pass that changes something sends the group back to its first pass.
+*/
+struct PipelineStep
+{
+    vector<const Pass *> passes;
+    bool repeat = false;
+};
+
+/** Settings of the passes chosen on the command line, the same for all the functions */
+struct PassSettings
+{
+    int unrollFactor = 4; /**< --unroll=N: copies of the body in an iteration of an unrolled loop, 1 to unroll none (see LoopUnroller) */
+};
+
+/** State of the pipeline on one function, given to its passes
+
+   Keeps the analyses until a pass invalidates them, the blocks changed since each pass last ran (the
+   worklist of the BLOCK passes, and of the FUNCTION passes that ask for it), the SSA form between
+   ssa-build and ssa-destroy, and the deadline of the running pass. The passes also find there the
+   settings of the command line and the stream of the remarks, where they explain their decisions.
+*/
+class PassContext
+{
+public:
+    explicit PassContext(CFG *cfg);
+
+    const DominatorTree &dominators(); /**< computed on first use, kept while the control flow does not change */
+    void invalidate_control_flow();
+
+    void changed(BasicBlock *bb); /**< its instructions or its edges changed: the BLOCK passes will visit it again */
+    void changed_all();
+    vector<BasicBlock *> changed_blocks() const; /**< changed since the running pass last ran (all of them on its first run), once each and still in the CFG: its worklist */
+    bool out_of_time() const; /**< the running pass has spent its budget: it should stop at the next consistent state */
+
+    unique_ptr<SSA> ssa; /**< between the passes ssa-build and ssa-destroy */
+    PassSettings settings;
+    ostream *remarks = nullptr; /**< --remarks: one line per decision of a pass, nullptr when not asked */
+
+protected:
+    friend class PassManager;
+
+    CFG *cfg;
+    unique_ptr<DominatorTree> dominatorTree;
+    vector<BasicBlock *> changedBlocks; /**< append only, each pass keeps its position in it */
+    map<const Pass *, size_t> cursors;
+    const Pass *running = nullptr;
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+};
+
+/** Runs a pipeline of passes on functions, with a time budget per pass and statistics
+
+   The budget is the time a pass may spend on one function, over all its runs. A pass that goes past
+   it is not run again on this function (it is counted in 'over budget'), and the passes that iterate
+   internally check out_of_time() to stop early. Required passes are not limited.
+   Functions may be optimized in parallel: the statistics are merged under a mutex.
+*/
+class PassManager
+{
+public:
+    PassManager(vector<PipelineStep> pipeline, chrono::milliseconds budget, PassSettings settings = PassSettings());
+
+    void run(CFG *cfg, ostream *remarks = nullptr); /**< remarks of the passes on this function, if asked */
+    void report(ostream &o) const; /**< runs, changes, time and budget overruns of each pass, over all the functions */
+
+    static const int maxRestarts = 64; /**< of a repeated group, in case its passes keep undoing each other */
+
+protected:
+    struct Statistics
+    {
+        size_t runs = 0;
+        size_t changes = 0;
+        size_t overBudget = 0;
+        chrono::steady_clock::duration time{};
+    };
+
+    bool runPass(const Pass *pass, CFG *cfg, PassContext &context, map<const Pass *, Statistics> &statistics) const;
+
+    vector<PipelineStep> pipeline;
+    chrono::milliseconds budget;
+    PassSettings settings;
+    vector<const Pass *> order; /**< of the first appearance of each pass in the pipeline, for the report */
+    map<const Pass *, Statistics> totals;
+    mutable mutex totalsMutex;
+};
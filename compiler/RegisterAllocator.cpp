@@ -0,0 +1,160 @@
+#include "RegisterAllocator.h"
+
+#include <algorithm>
+
+const vector<string> RegisterAllocator::callerSavedRegisters = {"%r10d", "%r11d"};
+const vector<string> RegisterAllocator::calleeSavedRegisters = {"%ebx", "%r12d", "%r13d", "%r14d", "%r15d"};
+
+static string register64(const string &reg)
+{
+    // %ebx -> %rbx, %r12d -> %r12
+    if (reg == "%ebx")
+        return "%rbx";
+    return reg.substr(0, reg.size() - 1);
+}
+
+RegisterAllocator::RegisterAllocator(CFG *cfg) : cfg(cfg) {}
+
+void RegisterAllocator::allocate()
+{
+    liveness = make_unique<Liveness>(cfg);
+    buildIntervals();
+    linearScan();
+}
+
+void RegisterAllocator::touch(int var, int position)
+{
+    // seules les variables locales (offset négatif) peuvent aller dans un registre,
+    // les paramètres au-delà du 6ème restent dans la pile de l'appelant
+    if (var >= 0)
+        return;
+
+    auto it = intervals.find(var);
+    if (it == intervals.end())
+    {
+        intervals[var] = {var, position, position};
+        return;
+    }
+    it->second.start = min(it->second.start, position);
+    it->second.end = max(it->second.end, position);
+}
+
+void RegisterAllocator::buildIntervals()
+{
+    // les paramètres sont écrits l'un après l'autre par le prologue, avant la première instruction :
+    // même inutilisé, un paramètre ne peut pas partager son registre avec un autre
+    for (const auto &param : cfg->ParamNumber)
+    {
+        touch(param.first, 0);
+        touch(param.first, 1);
+    }
+
+    int position = 2;
+    for (auto bb : *cfg->bbs)
+    {
+        liveness->in(bb).for_each([&](size_t n)
+                                  { touch(liveness->variable(n), position); });
+
+        for (auto instr : *bb->instrs)
+        {
+            for (int var : instr->get_used_vars())
+                touch(var, position);
+            int defined = instr->get_defined_var();
+            if (defined != 0)
+                touch(defined, position);
+            if (instr->op == call)
+                callPositions.push_back(position);
+            position += 2;
+        }
+
+        // position du saut de fin de bloc
+        if (bb->exit_false != nullptr)
+            touch(bb->test_var_index, position);
+        liveness->out(bb).for_each([&](size_t n)
+                                   { touch(liveness->variable(n), position); });
+        position += 2;
+    }
+
+    for (auto &entry : intervals)
+    {
+        Interval &interval = entry.second;
+        for (int callPosition : callPositions)
+            if (interval.start < callPosition && interval.end > callPosition)
+                interval.crossesCall = true;
+    }
+}
+
+void RegisterAllocator::linearScan()
+{
+    vector<Interval *> sorted;
+    for (auto &entry : intervals)
+        sorted.push_back(&entry.second);
+    stable_sort(sorted.begin(), sorted.end(), [](const Interval *a, const Interval *b)
+                { return a->start < b->start; });
+
+    map<int, string> assigned;
+    vector<Interval *> active; // trié par fin croissante
+    set<string> usedCalleeSaved;
+    // ordre de préférence : les registres callee-saved coûtent une sauvegarde dans le prologue
+    vector<string> registers = callerSavedRegisters;
+    registers.insert(registers.end(), calleeSavedRegisters.begin(), calleeSavedRegisters.end());
+    set<string> freeRegisters(registers.begin(), registers.end());
+
+    auto isCalleeSaved = [](const string &reg)
+    {
+        return find(calleeSavedRegisters.begin(), calleeSavedRegisters.end(), reg) != calleeSavedRegisters.end();
+    };
+    auto addActive = [&active](Interval *interval)
+    {
+        auto pos = upper_bound(active.begin(), active.end(), interval, [](const Interval *a, const Interval *b)
+                               { return a->end < b->end; });
+        active.insert(pos, interval);
+    };
+
+    for (Interval *current : sorted)
+    {
+        // libération des registres des intervalles terminés : toutes les instructions
+        // lisent leurs opérandes avant d'écrire leur destination
+        while (!active.empty() && active.front()->end <= current->start)
+        {
+            freeRegisters.insert(assigned[active.front()->var]);
+            active.erase(active.begin());
+        }
+
+        auto reg = find_if(registers.begin(), registers.end(), [&](const string &r)
+                           { return freeRegisters.count(r) != 0 && (!current->crossesCall || isCalleeSaved(r)); });
+        if (reg != registers.end())
+        {
+            assigned[current->var] = *reg;
+            freeRegisters.erase(*reg);
+            addActive(current);
+            continue;
+        }
+
+        // pas de registre libre : on vide en mémoire l'intervalle qui finit le plus tard
+        Interval *spill = nullptr;
+        for (auto it = active.rbegin(); it != active.rend(); it++)
+            if (!current->crossesCall || isCalleeSaved(assigned[(*it)->var]))
+            {
+                spill = *it;
+                break;
+            }
+        if (spill != nullptr && spill->end > current->end)
+        {
+            assigned[current->var] = assigned[spill->var];
+            assigned.erase(spill->var);
+            active.erase(find(active.begin(), active.end(), spill));
+            addActive(current);
+        }
+    }
+
+    for (const auto &entry : assigned)
+    {
+        cfg->registers[entry.first] = entry.second;
+        if (isCalleeSaved(entry.second))
+            usedCalleeSaved.insert(entry.second);
+    }
+    for (const string &reg : calleeSavedRegisters)
+        if (usedCalleeSaved.find(reg) != usedCalleeSaved.end())
+            cfg->savedRegisters.push_back(register64(reg));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CFG.h"
+#include "Liveness.h"
+
+using namespace std;
+
+/** Linear scan register allocator (Poletto & Sarkar)
+
+   Each IR variable (local variable or !tmp temporary) gets a live interval
+   over the linear order of the CFG's basic blocks (the order of emission), from the
+   variables live at the boundaries of the blocks (see Liveness).
+   The intervals are then scanned by increasing start: a variable gets a free
+   register if there is one, otherwise the interval ending the furthest is spilled
+   and keeps its stack slot.
+
+   Variables live across a call only get callee-saved registers, which are
+   saved by the prologue and restored by the epilogue.
+   %eax, %ecx and %edx stay free for IRInstr::gen_asm, the argument registers
+   for calls and for the prologue.
+*/
+class RegisterAllocator
+{
+public:
+    explicit RegisterAllocator(CFG *cfg);
+    void allocate();
+
+protected:
+    struct Interval
+    {
+        int var;
+        int start;
+        int end;
+        bool crossesCall = false;
+    };
+
+    void buildIntervals();
+    void linearScan();
+    void touch(int var, int position);
+
+    CFG *cfg;
+    unique_ptr<Liveness> liveness;
+    map<int, Interval> intervals;
+    vector<int> callPositions;
+
+    static const vector<string> callerSavedRegisters;
+    static const vector<string> calleeSavedRegisters;
+};
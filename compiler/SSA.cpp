@@ -0,0 +1,262 @@
+#include "SSA.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "CopyCoalescer.h"
+
+SSA::SSA(CFG *cfg) : cfg(cfg) {}
+
+void SSA::build(const DominatorTree &tree)
+{
+    // un branchement dont les deux sorties sont identiques est un saut simple (les dominateurs ne changent pas)
+    for (auto bb : *cfg->bbs)
+        if (bb->exit_false == bb->exit_true)
+            bb->set_exit_false(nullptr);
+
+    removeUnreachableBlocks(tree);
+    insertPhis(tree);
+    rename(cfg->bbs->front(), tree);
+}
+
+void SSA::removeUnreachableBlocks(const DominatorTree &tree)
+{
+    vector<BasicBlock *> reachable;
+    for (auto bb : *cfg->bbs)
+        if (tree.is_reachable(bb))
+            reachable.push_back(bb);
+        else
+            bb->detach();
+    cfg->bbs->assign(reachable.begin(), reachable.end());
+}
+
+void SSA::insertPhis(const DominatorTree &tree)
+{
+    // variables lues dans un bloc avant d'y être écrites : seules celles-ci ont besoin de phi
+    set<int> globals;
+    map<int, vector<BasicBlock *>> definitionBlocks;
+    for (auto bb : *cfg->bbs)
+    {
+        set<int> defined;
+        for (auto instr : *bb->instrs)
+        {
+            for (int var : instr->get_used_vars())
+                if (defined.find(var) == defined.end())
+                    globals.insert(var);
+            int var = instr->get_defined_var();
+            if (var != 0 && defined.insert(var).second)
+                definitionBlocks[var].push_back(bb);
+        }
+        if (bb->exit_false != nullptr && defined.find(bb->test_var_index) == defined.end())
+            globals.insert(bb->test_var_index);
+    }
+
+    for (int var : globals)
+    {
+        set<BasicBlock *> hasPhi;
+        vector<BasicBlock *> worklist = definitionBlocks[var];
+        set<BasicBlock *> inWorklist(worklist.begin(), worklist.end());
+        while (!worklist.empty())
+        {
+            BasicBlock *bb = worklist.back();
+            worklist.pop_back();
+            for (auto join : tree.get_frontier(bb))
+            {
+                if (!hasPhi.insert(join).second)
+                    continue;
+
+                // P0 = phi(label1: P0, label2: P0, ...), les opérandes sont renommés ensuite
+                vector<Operand> params = {Operand::variable(var)};
+                for (auto pred : tree.get_predecessors(join))
+                {
+                    params.push_back(Operand::label(pred));
+                    params.push_back(Operand::variable(var));
+                }
+                auto instr = cfg->create_instr(join, phi, params);
+                join->instrs->insert(join->instrs->begin(), instr);
+                phiVariables[instr] = var;
+
+                if (inWorklist.insert(join).second)
+                    worklist.push_back(join);
+            }
+        }
+    }
+}
+
+int SSA::currentVersion(int var) const
+{
+    // sans définition dominante, la variable garde sa valeur d'entrée (paramètre, variable non initialisée)
+    auto it = versions.find(var);
+    if (it == versions.end() || it->second.empty())
+        return var;
+    return it->second.back();
+}
+
+int SSA::newVersion(int var, vector<int> &pushed)
+{
+    int version = cfg->create_new_tempvar(INT);
+    versions[var].push_back(version);
+    pushed.push_back(var);
+    return version;
+}
+
+void SSA::renameUses(IRInstr *instr)
+{
+    if (instr->op == phi)
+        return;
+    // P0 = op P0 devient P0 = op P1 : la destination est une nouvelle version
+    if ((instr->op == neg || instr->op == lnot || instr->op == bwnot || instr->op == incr || instr->op == decr) && instr->params.size() == 1)
+        instr->params.push_back(instr->params[0]);
+    for (unsigned long i : instr->get_source_indices())
+        if (instr->params[i].is_variable())
+            instr->params[i] = Operand::variable(currentVersion(instr->params[i].get_index()));
+}
+
+void SSA::rename(BasicBlock *entry, const DominatorTree &tree)
+{
+    // parcours en profondeur itératif de l'arbre des dominateurs :
+    // on dépile les versions créées par un bloc quand tout son sous-arbre a été renommé
+    vector<pair<BasicBlock *, vector<int>>> stack;
+    vector<unsigned long> nextChild;
+    stack.emplace_back(entry, vector<int>());
+    nextChild.push_back(0);
+
+    bool enter = true;
+    while (!stack.empty())
+    {
+        BasicBlock *bb = stack.back().first;
+        vector<int> &pushed = stack.back().second;
+
+        if (enter)
+        {
+            for (auto instr : *bb->instrs)
+            {
+                renameUses(instr);
+                int defined = instr->get_defined_var();
+                if (defined == 0)
+                    continue;
+                int var = instr->op == phi ? phiVariables[instr] : defined;
+                instr->params[0] = Operand::variable(newVersion(var, pushed));
+            }
+            if (bb->exit_false != nullptr)
+                bb->test_var_index = currentVersion(bb->test_var_index);
+
+            for (auto succ : DominatorTree::successors(bb))
+                for (auto instr : *succ->instrs)
+                {
+                    if (instr->op != phi)
+                        break;
+                    for (unsigned long i = 1; i < instr->params.size(); i += 2)
+                        if (instr->params[i].get_block() == bb)
+                            instr->params[i + 1] = Operand::variable(currentVersion(phiVariables[instr]));
+                }
+        }
+
+        const vector<BasicBlock *> &children = tree.get_children(bb);
+        if (nextChild.back() < children.size())
+        {
+            stack.emplace_back(children[nextChild.back()++], vector<int>());
+            nextChild.push_back(0);
+            enter = true;
+            continue;
+        }
+
+        for (int var : pushed)
+            versions[var].pop_back();
+        stack.pop_back();
+        nextChild.pop_back();
+        enter = false;
+    }
+}
+
+void SSA::destroy()
+{
+    splitCriticalEdges();
+
+    // copies parallèles à la fin de chaque prédécesseur, dans l'ordre des blocs
+    map<BasicBlock *, vector<pair<Operand, Operand>>> copies;
+    for (auto bb : *cfg->bbs)
+    {
+        auto firstNonPhi = bb->instrs->begin();
+        while (firstNonPhi != bb->instrs->end() && (*firstNonPhi)->op == phi)
+        {
+            IRInstr *instr = *firstNonPhi;
+            for (unsigned long i = 1; i < instr->params.size(); i += 2)
+                copies[instr->params[i].get_block()].emplace_back(instr->params[0], instr->params[i + 1]);
+            firstNonPhi++;
+        }
+        bb->instrs->erase(bb->instrs->begin(), firstNonPhi);
+    }
+    for (auto bb : *cfg->bbs)
+        if (copies.find(bb) != copies.end())
+            insertCopies(bb, copies[bb]);
+
+    CopyCoalescer(cfg).coalesce(phiCopies);
+    phiVariables.clear();
+    phiCopies.clear();
+}
+
+void SSA::splitCriticalEdges()
+{
+    // un bloc à deux sorties ne peut pas recevoir les copies d'une seule d'entre elles
+    unsigned long size = cfg->bbs->size();
+    for (unsigned long i = 0; i < size; i++)
+    {
+        BasicBlock *bb = (*cfg->bbs)[i];
+        if (bb->exit_false == nullptr)
+            continue;
+        for (bool trueExit : {true, false})
+        {
+            BasicBlock *succ = trueExit ? bb->exit_true : bb->exit_false;
+            if (succ->instrs->empty() || succ->instrs->front()->op != phi)
+                continue;
+
+            auto edge = cfg->create_bb(cfg->new_BB_name("edge"));
+            edge->set_exit_true(succ);
+            cfg->add_bb(edge);
+            if (trueExit)
+                bb->set_exit_true(edge);
+            else
+                bb->set_exit_false(edge);
+            for (auto instr : *succ->instrs)
+            {
+                if (instr->op != phi)
+                    break;
+                for (unsigned long j = 1; j < instr->params.size(); j += 2)
+                    if (instr->params[j].get_block() == bb)
+                        instr->params[j] = Operand::label(edge);
+            }
+        }
+    }
+}
+
+void SSA::insertCopies(BasicBlock *bb, vector<pair<Operand, Operand>> copies)
+{
+    copies.erase(remove_if(copies.begin(), copies.end(), [](const pair<Operand, Operand> &copy)
+                           { return copy.first == copy.second; }),
+                 copies.end());
+
+    // séquentialisation : une copie peut être faite dès que sa destination n'est plus lue par une autre
+    while (!copies.empty())
+    {
+        auto ready = find_if(copies.begin(), copies.end(), [&copies](const pair<Operand, Operand> &copy)
+                             { return none_of(copies.begin(), copies.end(), [&copy](const pair<Operand, Operand> &other)
+                                              { return other.second == copy.first; }); });
+        if (ready != copies.end())
+        {
+            auto instr = cfg->create_instr(bb, copyvar, {ready->first, ready->second});
+            bb->instrs->push_back(instr);
+            phiCopies.push_back(instr);
+            copies.erase(ready);
+            continue;
+        }
+
+        // cycle : on sauvegarde la destination de la première copie dans un temporaire
+        Operand dest = copies.front().first;
+        Operand tmp = Operand::variable(cfg->create_new_tempvar(INT));
+        bb->instrs->push_back(cfg->create_instr(bb, copyvar, {tmp, dest}));
+        for (auto &copy : copies)
+            if (copy.second == dest)
+                copy.second = tmp;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CFG.h"
+#include "DominatorTree.h"
+
+using namespace std;
+
+/** Static single assignment form of a CFG
+
+   build() puts the CFG in SSA form (Cytron et al.):
+     - phi instructions are inserted at the iterated dominance frontier of the
+       definitions of each variable live across blocks (semi-pruned SSA),
+     - every definition then gets a new temporary variable, renamed along the
+       dominator tree. The value of a variable on entry (parameters, uninitialised
+       variables) keeps the original name.
+   In-place unary instructions (neg P0, incr P0...) become two-operand ones (neg P0, P1).
+
+   destroy() goes back to executable IR before gen_asm:
+     - critical edges leading to a block with phi instructions are split,
+     - each phi becomes a parallel copy at the end of its predecessors, sequentialized
+       with a temporary when copies form a cycle,
+     - phi-related variables whose lifetimes do not overlap are coalesced (CopyCoalescer),
+       which removes most of these copies.
+
+   The CFG must not contain jump instructions anymore (see IROptimizer::replaceJumpInstructions).
+*/
+class SSA
+{
+public:
+    explicit SSA(CFG *cfg);
+    void build(const DominatorTree &tree); /**< tree: dominators of the CFG as it is given */
+    void destroy();
+
+protected:
+    void removeUnreachableBlocks(const DominatorTree &tree);
+    void insertPhis(const DominatorTree &tree);
+    void rename(BasicBlock *bb, const DominatorTree &tree);
+    void renameUses(IRInstr *instr);
+    int currentVersion(int var) const;
+    int newVersion(int var, vector<int> &pushed);
+
+    void splitCriticalEdges();
+    void insertCopies(BasicBlock *bb, vector<pair<Operand, Operand>> copies);
+
+    CFG *cfg;
+    map<int, vector<int>> versions; /**< renaming stacks: original variable -> its current versions */
+    map<IRInstr *, int> phiVariables; /**< original variable of each phi instruction */
+    vector<IRInstr *> phiCopies; /**< copies inserted by destroy() */
+};
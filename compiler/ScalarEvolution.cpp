@@ -0,0 +1,523 @@
+#include "ScalarEvolution.h"
+#include "IROptimizer.h"
+
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
+// a + factor * b, les termes nuls disparaissent
+static void accumulate(map<int, unsigned> &terms, unsigned &constant, const map<int, unsigned> &otherTerms, unsigned otherConstant, unsigned factor)
+{
+    for (auto &term : otherTerms)
+    {
+        unsigned coefficient = terms[term.first] + factor * term.second;
+        if (coefficient == 0)
+            terms.erase(term.first);
+        else
+            terms[term.first] = coefficient;
+    }
+    constant += factor * otherConstant;
+}
+
+ScalarEvolution::UseIndex::UseIndex(CFG *cfg)
+{
+    for (auto bb : *cfg->bbs)
+    {
+        for (auto instr : *bb->instrs)
+            add(bb, instr);
+        if (bb->exit_false != nullptr)
+            uses[bb->test_var_index].push_back({bb, nullptr});
+    }
+}
+
+void ScalarEvolution::UseIndex::add(BasicBlock *bb, IRInstr *instr)
+{
+    for (int var : instr->get_used_vars())
+    {
+        vector<Use> &varUses = uses[var];
+        // une instruction qui lit deux fois la même variable n'y est qu'une fois
+        if (varUses.empty() || varUses.back().instr != instr)
+            varUses.push_back({bb, instr});
+    }
+}
+
+void ScalarEvolution::UseIndex::replaceUses(int var, const Operand &value)
+{
+    auto it = uses.find(var);
+    if (it == uses.end())
+        return;
+    vector<Use> varUses = std::move(it->second);
+    uses.erase(it);
+    for (auto &use : varUses)
+    {
+        if (use.instr == nullptr)
+            use.bb->test_var_index = value.get_index();
+        else
+            for (unsigned long i : use.instr->get_source_indices())
+                if (use.instr->params[i].is_variable() && use.instr->params[i].get_index() == var)
+                    use.instr->params[i] = value;
+        uses[value.get_index()].push_back(use);
+    }
+}
+
+ScalarEvolution::ScalarEvolution(CFG *cfg, Loop *loop) : cfg(cfg), loop(loop), preheader(loop->preheader)
+{
+    analyze();
+}
+
+void ScalarEvolution::analyze()
+{
+    // un seul arc retour et une seule entrée : chaque phi de l'en-tête a une valeur initiale et une valeur suivante
+    BasicBlock *header = loop->header;
+    valid = loop->latches.size() == 1 && preheader != nullptr && header->predecessors->size() == 2;
+    if (!valid)
+        return;
+    latch = loop->latches.front();
+    for (auto bb : loop->blocks)
+        for (auto instr : *bb->instrs)
+            if (instr->get_defined_var() != 0)
+            {
+                definedInLoop.insert(instr->get_defined_var());
+                definitions[instr->get_defined_var()] = instr;
+            }
+
+    // en SSA et dans l'ordre postfixe inverse, les opérandes sont vus avant les instructions qui les lisent,
+    // sauf par les phi : ceux de l'en-tête sont les inconnues des récurrences, les autres sont inconnus
+    for (auto bb : loop->blocks)
+        for (auto instr : *bb->instrs)
+        {
+            int defined = instr->get_defined_var();
+            if (defined == 0)
+                continue;
+            Recurrence result, a, b;
+            bool known;
+            switch (instr->op)
+            {
+            case phi:
+                known = bb == header;
+                result.terms[defined] = 1;
+                break;
+            case ldconst:
+                known = true;
+                result.constant = instr->params[1].get_value();
+                break;
+            case copyvar:
+                known = recurrence(instr->params[1], result);
+                break;
+            case add:
+            case sub:
+                known = recurrence(instr->params[1], result) && recurrence(instr->params[2], b);
+                accumulate(result.terms, result.constant, b.terms, b.constant, instr->op == add ? 1 : -1u);
+                break;
+            case neg:
+                known = recurrence(instr->params.back(), b);
+                accumulate(result.terms, result.constant, b.terms, b.constant, -1u);
+                break;
+            case incr:
+            case decr:
+                known = recurrence(instr->params.back(), result);
+                result.constant += instr->op == incr ? 1 : -1u;
+                break;
+            case mul:
+                // un des facteurs doit être constant
+                known = recurrence(instr->params[1], a) && recurrence(instr->params[2], b) && (a.terms.empty() || b.terms.empty());
+                if (known && a.terms.empty())
+                    swap(a, b);
+                if (known)
+                    accumulate(result.terms, result.constant, a.terms, a.constant, b.constant);
+                break;
+            case bwsl:
+                known = instr->params[2].is_immediate() && recurrence(instr->params[1], a);
+                if (known)
+                    accumulate(result.terms, result.constant, a.terms, a.constant, 1u << (instr->params[2].get_value() & 31));
+                break;
+            default:
+                known = false;
+            }
+            if (known)
+                recurrences[defined] = result;
+        }
+
+    // i = phi(préen-tête : i0, arc retour : i + pas) : le pas ne dépend pas des phi pour une variable
+    // d'induction, il ne dépend que de variables d'induction (avec des coefficients constants) pour un accumulateur
+    for (auto instr : *header->instrs)
+    {
+        if (instr->op != phi)
+            break;
+        int variable = instr->params[0].get_index();
+        Evolution evolution;
+        Operand next;
+        for (unsigned long i = 1; i < instr->params.size(); i += 2)
+            if (instr->params[i].get_block() == preheader)
+                evolution.initial = instr->params[i + 1];
+            else
+                next = instr->params[i + 1];
+        Recurrence step;
+        if (instr->params.size() != 5 || !recurrence(next, step) || step.terms[variable] != 1)
+            continue;
+        step.terms.erase(variable);
+        evolution.step = step;
+        evolution.basic = isInvariant(step);
+        evolutions[variable] = evolution;
+    }
+    for (auto it = evolutions.begin(); it != evolutions.end();)
+    {
+        bool known = it->second.basic;
+        if (!known)
+        {
+            known = true;
+            for (auto &term : it->second.step.terms)
+                if (definedInLoop.count(term.first) != 0)
+                {
+                    auto induction = evolutions.find(term.first);
+                    known = known && induction != evolutions.end() && induction->second.basic;
+                }
+        }
+        it = known ? next(it) : evolutions.erase(it);
+    }
+}
+
+bool ScalarEvolution::recurrence(const Operand &operand, Recurrence &result) const
+{
+    result = Recurrence();
+    if (operand.is_immediate())
+    {
+        result.constant = operand.get_value();
+        return true;
+    }
+    int variable = operand.get_index();
+    if (definedInLoop.count(variable) == 0)
+    {
+        result.terms[variable] = 1;
+        return true;
+    }
+    auto it = recurrences.find(variable);
+    if (it == recurrences.end())
+        return false;
+    result = it->second;
+    return true;
+}
+
+bool ScalarEvolution::isInvariant(const Recurrence &recurrence) const
+{
+    for (auto &term : recurrence.terms)
+        if (definedInLoop.count(term.first) != 0)
+            return false;
+    return true;
+}
+
+bool ScalarEvolution::findTripCount(TripCount &trip) const
+{
+    // la boucle continue tant que i + e condition borne, i variable d'induction dont le pas est une puissance de 2 :
+    // elle ne déborde pas avant de sortir, ou elle ne sort jamais (les valeurs de i forment un cycle modulo 2^32
+    // qui saute la sortie), ce qu'une boucle sans effet de bord peut supposer ne pas faire
+    if (latch->exit_false == nullptr)
+        return false;
+    auto definition = definitions.find(latch->test_var_index);
+    if (definition == definitions.end())
+        return false;
+    IRInstr *test = definition->second;
+    Operation condition = test->op;
+    if (condition != cmp_lt && condition != cmp_le && condition != cmp_gt && condition != cmp_ge)
+        return false;
+    if (latch->exit_false == loop->header)
+        condition = negated(condition);
+    else if (latch->exit_true != loop->header)
+        return false;
+
+    Recurrence left, right;
+    if (!recurrence(test->params[1], left) || !recurrence(test->params[2], right))
+        return false;
+    if (isInvariant(left))
+    {
+        swap(left, right);
+        condition = mirrored(condition);
+    }
+    if (!isInvariant(right))
+        return false;
+    int induction = 0;
+    for (auto &term : left.terms)
+        if (definedInLoop.count(term.first) != 0)
+        {
+            if (induction != 0 || term.second != 1)
+                return false;
+            induction = term.first;
+        }
+    auto evolution = evolutions.find(induction);
+    if (evolution == evolutions.end() || !evolution->second.basic || !evolution->second.step.terms.empty())
+        return false;
+
+    int step = evolution->second.step.constant;
+    bool increasing = condition == cmp_lt || condition == cmp_le;
+    if (step == 0 || step == INT_MIN || (step > 0) != increasing)
+        return false;
+    unsigned magnitude = step > 0 ? step : -step;
+    if ((magnitude & (magnitude - 1)) != 0 || magnitude > (1u << 30))
+        return false;
+    trip.shift = 0;
+    while ((1u << trip.shift) != magnitude)
+        trip.shift++;
+    left.terms.erase(induction);
+    trip.induction = induction;
+    trip.offset = left;
+    trip.bound = right;
+    trip.condition = condition;
+    return true;
+}
+
+Operand ScalarEvolution::emitLastIteration(const TripCount &trip)
+{
+    // w0 = i0 + e au premier test ; tant que w0 < n (pas c = 2^k) : d = n - w0, la boucle sort au tour
+    // ceil(d / c) = ((d - 1) >> k) + 1 (décalage logique), au tour 0 si le premier test échoue.
+    // Pour <=, floor(d / c) + 1 = (d >> k) + 1 ; pour > et >=, d = w0 - n
+    map<int, Operand> initial = {{trip.induction, evolutions[trip.induction].initial}};
+    Recurrence first = trip.offset;
+    first.terms[trip.induction] = 1;
+    Operand start = emitValue(first, initial);
+    Operand bound = emitValue(trip.bound, {});
+    Operand passes = emit(trip.condition, start, bound);
+    bool increasing = trip.condition == cmp_lt || trip.condition == cmp_le;
+    Operand distance = increasing ? emit(sub, bound, start) : emit(sub, start, bound);
+    bool strict = trip.condition == cmp_lt || trip.condition == cmp_gt;
+    if (trip.shift == 0)
+        return emit(mul, passes, strict ? distance : emit(add, distance, Operand::immediate(1)));
+    if (strict)
+        distance = emit(sub, distance, Operand::immediate(1));
+    distance = emit(bwsr, distance, Operand::immediate(trip.shift));
+    distance = emit(bwand, distance, Operand::immediate(0xFFFFFFFFu >> trip.shift));
+    return emit(mul, passes, emit(add, distance, Operand::immediate(1)));
+}
+
+Operand ScalarEvolution::emitValue(const Recurrence &recurrence, const map<int, Operand> &values)
+{
+    Operand result = Operand::immediate(recurrence.constant);
+    for (auto &term : recurrence.terms)
+    {
+        auto value = values.find(term.first);
+        Operand operand = value != values.end() ? value->second : Operand::variable(term.first);
+        result = emit(add, result, emit(mul, operand, Operand::immediate(term.second)));
+    }
+    return result;
+}
+
+Operand ScalarEvolution::emitPhiValue(int phi, const Operand &iteration, Operand &triangle)
+{
+    // i(j) = i0 + j * pas ; s(j) = s0 + j * (somme des a_k i_k0 + inv) + j (j - 1) / 2 * somme des a_k pas_k,
+    // j (j - 1) / 2 = (j / 2) * (j - 1) si j est pair, j * ((j - 1) / 2) sinon : ((j >> 1) & INT_MAX) * ((j - 1) | 1)
+    const Evolution &evolution = evolutions[phi];
+    if (evolution.basic)
+        return emit(add, evolution.initial, emit(mul, emitValue(evolution.step, {}), iteration));
+    map<int, Operand> initial;
+    Recurrence growth;
+    for (auto &term : evolution.step.terms)
+        if (definedInLoop.count(term.first) != 0)
+        {
+            const Evolution &induction = evolutions[term.first];
+            initial[term.first] = induction.initial;
+            accumulate(growth.terms, growth.constant, induction.step.terms, induction.step.constant, term.second);
+        }
+    Operand value = emit(add, evolution.initial, emit(mul, emitValue(evolution.step, initial), iteration));
+    Operand increment = emitValue(growth, {});
+    if (increment.is_immediate() && increment.get_value() == 0)
+        return value;
+    if (triangle.is_variable() && triangle.get_index() == 0)
+    {
+        Operand half = emit(bwand, emit(bwsr, iteration, Operand::immediate(1)), Operand::immediate(INT_MAX));
+        triangle = emit(mul, half, emit(bwor, emit(sub, iteration, Operand::immediate(1)), Operand::immediate(1)));
+    }
+    return emit(add, value, emit(mul, triangle, increment));
+}
+
+Operand ScalarEvolution::emit(Operation op, const Operand &a, const Operand &b)
+{
+    int folded;
+    if (a.is_immediate() && b.is_immediate() && IROptimizer::foldOperation(op, {a.get_value(), b.get_value()}, folded))
+        return Operand::immediate(folded);
+    // les identités des sommes et produits construits par les récurrences
+    bool commutative = op == add || op == mul || op == bwand || op == bwor;
+    if (commutative && a.is_immediate())
+        return emit(op, b, a);
+    if (b.is_immediate() && b.get_value() == 0 && (op == add || op == sub || op == bwor || op == bwsr))
+        return a;
+    if (b.is_immediate() && b.get_value() == 0 && (op == mul || op == bwand))
+        return b;
+    if (b.is_immediate() && b.get_value() == 1 && op == mul)
+        return a;
+    if (b.is_immediate() && b.get_value() == -1 && op == bwand)
+        return a;
+    Operand result = Operand::variable(cfg->create_new_tempvar(INT));
+    preheader->instrs->push_back(cfg->create_instr(preheader, op, {result, a, b}));
+    return result;
+}
+
+bool ScalarEvolution::replaceExitValues(UseIndex &index)
+{
+    // une boucle la plus interne, sans effet de bord, qui ne sort que par le test de son arc retour
+    if (!valid || !loop->children.empty())
+        return false;
+    vector<pair<BasicBlock *, BasicBlock *>> exits = loop->exits();
+    if (exits.size() != 1 || exits.front().first != latch)
+        return false;
+    BasicBlock *exit = exits.front().second;
+    for (auto bb : loop->blocks)
+        for (auto instr : *bb->instrs)
+            if (instr->op == call || instr->op == ret || instr->op == ret_cst || instr->op == jump || instr->op == rmem || instr->op == wmem)
+                return false;
+    TripCount trip;
+    if (!findTripCount(trip))
+        return false;
+
+    // les variables de la boucle lues après elle : leur valeur au dernier tour doit être connue.
+    // Les lectures dans les blocs des boucles déjà retirées ne comptent plus
+    auto outsideUses = [&](int var)
+    {
+        vector<UseIndex::Use> found;
+        auto it = index.uses.find(var);
+        if (it != index.uses.end())
+            for (auto &use : it->second)
+                if (!loop->contains(use.bb) && index.removed.count(use.bb) == 0)
+                    found.push_back(use);
+        return found;
+    };
+    vector<int> outside;
+    for (auto bb : loop->blocks)
+        for (auto instr : *bb->instrs)
+        {
+            int var = instr->get_defined_var();
+            if (var == 0 || outsideUses(var).empty())
+                continue;
+            auto it = recurrences.find(var);
+            if (it == recurrences.end())
+                return false;
+            for (auto &term : it->second.terms)
+                if (definedInLoop.count(term.first) != 0 && evolutions.find(term.first) == evolutions.end())
+                    return false;
+            outside.push_back(var);
+        }
+
+    // les valeurs, calculées dans le préen-tête qui mène désormais à la sortie
+    unsigned long emitted = preheader->instrs->size();
+    Operand last = emitLastIteration(trip);
+    Operand triangle;
+    map<int, Operand> atLast;
+    map<int, int> renamed;
+    for (int var : outside)
+    {
+        for (auto &term : recurrences[var].terms)
+            if (definedInLoop.count(term.first) != 0 && atLast.count(term.first) == 0)
+                atLast[term.first] = emitPhiValue(term.first, last, triangle);
+        Operand value = emitValue(recurrences[var], atLast);
+        if (value.is_immediate())
+        {
+            Operand constant = Operand::variable(cfg->create_new_tempvar(INT));
+            preheader->instrs->push_back(cfg->create_instr(preheader, ldconst, {constant, value}));
+            value = constant;
+        }
+        renamed[var] = value.get_index();
+    }
+    // les lectures dans la boucle sont renommées aussi, ses blocs sont retirés juste après
+    for (int var : outside)
+        index.replaceUses(var, Operand::variable(renamed[var]));
+    for (unsigned long i = emitted; i < preheader->instrs->size(); i++)
+        index.add(preheader, (*preheader->instrs)[i]);
+
+    preheader->set_exit_true(exit);
+    for (auto instr : *exit->instrs)
+    {
+        if (instr->op != phi)
+            break;
+        for (unsigned long i = 1; i < instr->params.size(); i += 2)
+            if (instr->params[i].get_block() == latch)
+                instr->params[i] = Operand::label(preheader);
+    }
+    for (auto bb : loop->blocks)
+    {
+        bb->detach();
+        index.removed.insert(bb);
+    }
+    return true;
+}
+
+int ScalarEvolution::reduceStrength(UseIndex &index)
+{
+    // x * y, x = a * i + r (i variable d'induction), y variable invariante : q = phi(préen-tête : a * y * i0, arc retour : q + a * y * pas)
+    // vaut a * y * i à chaque tour, le produit devient q + r * y. Un produit par une constante reste : il coûte moins
+    // qu'une variable de plus vivante dans toute la boucle
+    if (!valid)
+        return 0;
+    map<tuple<int, unsigned, int>, int> reduced; /**< (i, a, y) -> q */
+    int replaced = 0;
+    unsigned long emitted = preheader->instrs->size();
+    for (auto bb : loop->blocks)
+        for (unsigned long position = 0; position < bb->instrs->size(); position++)
+        {
+            IRInstr *instr = (*bb->instrs)[position];
+            if (instr->op != mul)
+                continue;
+            for (unsigned long side : {1, 2})
+            {
+                Operand factor = instr->params[3 - side];
+                Recurrence x;
+                if (factor.is_immediate() || definedInLoop.count(factor.get_index()) != 0 || !recurrence(instr->params[side], x))
+                    continue;
+                int induction = 0, inductions = 0;
+                unsigned coefficient = 0;
+                for (auto &term : x.terms)
+                    if (definedInLoop.count(term.first) != 0)
+                    {
+                        induction = term.first;
+                        coefficient = term.second;
+                        inductions++;
+                    }
+                auto evolution = evolutions.find(induction);
+                if (inductions != 1 || evolution == evolutions.end() || !evolution->second.basic)
+                    continue;
+
+                auto key = make_tuple(induction, coefficient, factor.get_index());
+                if (reduced.count(key) == 0)
+                {
+                    Operand scale = emit(mul, factor, Operand::immediate(coefficient));
+                    Operand initial = emit(mul, evolution->second.initial, scale);
+                    Operand increment = emit(mul, emitValue(evolution->second.step, {}), scale);
+                    int product = cfg->create_new_tempvar(INT);
+                    int next = cfg->create_new_tempvar(INT);
+                    BasicBlock *header = loop->header;
+                    header->instrs->insert(header->instrs->begin(), cfg->create_instr(header, phi, {Operand::variable(product), Operand::label(preheader), initial, Operand::label(latch), Operand::variable(next)}));
+                    index.add(header, header->instrs->front());
+                    if (bb == header)
+                        position++;
+                    auto firstNonPhi = latch->instrs->begin();
+                    while (firstNonPhi != latch->instrs->end() && (*firstNonPhi)->op == phi)
+                        firstNonPhi++;
+                    if (bb == latch && (unsigned long)(firstNonPhi - latch->instrs->begin()) <= position)
+                        position++;
+                    index.add(latch, *latch->instrs->insert(firstNonPhi, cfg->create_instr(latch, add, {Operand::variable(next), Operand::variable(product), increment})));
+                    definedInLoop.insert(product);
+                    definedInLoop.insert(next);
+                    reduced[key] = product;
+                }
+
+                x.terms.erase(induction);
+                Operand offset = emit(mul, emitValue(x, {}), factor);
+                Operand product = Operand::variable(reduced[key]);
+                if (offset.is_immediate() && offset.get_value() == 0)
+                {
+                    // le produit est q : ses lectures, trouvées dans l'index, lisent q
+                    index.replaceUses(instr->get_defined_var(), product);
+                    bb->instrs->erase(bb->instrs->begin() + position);
+                    position--;
+                }
+                else
+                {
+                    (*bb->instrs)[position] = cfg->create_instr(bb, add, {instr->params[0], product, offset});
+                    index.add(bb, (*bb->instrs)[position]);
+                }
+                replaced++;
+                break;
+            }
+        }
+    // les instructions du préen-tête lisent des variables qu'une boucle englobante peut encore remplacer
+    for (unsigned long i = emitted; i < preheader->instrs->size(); i++)
+        index.add(preheader, (*preheader->instrs)[i]);
+    return replaced;
+}
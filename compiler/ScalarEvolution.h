@@ -0,0 +1,106 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "CFG.h"
+#include "LoopNest.h"
+
+using namespace std;
+
+/** Scalar evolution of the variables of a loop in SSA form, and the two transformations built on it
+
+   The value of a variable of the loop during an iteration is described, when possible, by a
+   Recurrence: a linear combination of the phi instructions of the header and of variables defined
+   out of the loop, plus a constant (i + 1, 3 * i + n, s + i...). Across the iterations j = 0, 1...
+   a phi of the header is:
+     - a basic induction variable when its next value (from the latch) is itself plus an invariant
+       step: i(j) = i(0) + j * step,
+     - an accumulator when its next value is itself plus basic induction variables with constant
+       coefficients and an invariant: s(j) = s(0) + j * (sum a_k i_k(0) + inv) + j (j - 1) / 2 * sum a_k step_k.
+   All the arithmetic is modulo 2^32, like the compiled code.
+
+   replaceExitValues(): when an innermost loop has no side effect and its trip count can be computed
+   (its latch tests i + e against an invariant bound, i a basic induction variable whose step is a
+   power of two), the values it computes for the code after it are computed in closed form in its
+   preheader, which goes straight to the exit: the loop is removed.
+   reduceStrength(): the product of a Recurrence a * i + r, i a basic induction variable, by a
+   variable y defined out of the loop becomes q + r * y, where q = a * y * i is a new phi of the
+   header that the latch increments by a * y * step. q and r * y are computed once for all the
+   products of the same a * y * i. Products by a constant are left as they are.
+
+   The loop must have a single latch and a preheader (see LoopNest::create_preheaders).
+   Both find the reads of the values of the loop in a UseIndex of the function, built once for all
+   its loops: the cost of a loop does not depend on the size of the function.
+*/
+class ScalarEvolution
+{
+public:
+    /** Instructions and tests of blocks that read each variable of a function
+
+       Kept up to date by replaceExitValues() and reduceStrength(), which add the instructions they
+       create, and by replaceExitValues() with the blocks of the loops it removes: these blocks are
+       still in CFG::bbs, to be taken out in a single sweep.
+    */
+    struct UseIndex
+    {
+        struct Use
+        {
+            BasicBlock *bb;
+            IRInstr *instr; /**< nullptr for the test of bb */
+        };
+
+        explicit UseIndex(CFG *cfg);
+        void add(BasicBlock *bb, IRInstr *instr);
+        void replaceUses(int var, const Operand &value); /**< every read of var reads value instead, a variable */
+
+        unordered_map<int, vector<Use>> uses;
+        unordered_set<BasicBlock *> removed;
+    };
+
+    ScalarEvolution(CFG *cfg, Loop *loop);
+    bool replaceExitValues(UseIndex &index); /**< true if the loop was removed */
+    int reduceStrength(UseIndex &index); /**< number of multiplications replaced */
+
+protected:
+    struct Recurrence
+    {
+        map<int, unsigned> terms; /**< variable -> coefficient: phi instructions of the header, invariant variables */
+        unsigned constant = 0;
+    };
+    struct Evolution
+    {
+        Operand initial; /**< value entering the loop */
+        Recurrence step; /**< invariant for a basic induction variable, with basic induction variables for an accumulator */
+        bool basic;
+    };
+    struct TripCount
+    {
+        int induction; /**< basic induction variable i of the test i + offset condition bound */
+        Recurrence offset;
+        Recurrence bound;
+        Operation condition; /**< cmp_lt, cmp_le, cmp_gt or cmp_ge: the loop goes on while it holds */
+        int shift; /**< log2 of the absolute value of the step of i */
+    };
+
+    void analyze();
+    bool recurrence(const Operand &operand, Recurrence &result) const; /**< false if the operand evolves in an unknown way */
+    bool isInvariant(const Recurrence &recurrence) const;
+    bool findTripCount(TripCount &trip) const;
+    Operand emitLastIteration(const TripCount &trip); /**< number of the last iteration (the trip count - 1) */
+    Operand emitValue(const Recurrence &recurrence, const map<int, Operand> &values); /**< values: of the phi instructions of the header in its terms */
+    Operand emitPhiValue(int phi, const Operand &iteration, Operand &triangle); /**< value of a phi of the header at an iteration, triangle: iteration (iteration - 1) / 2, computed on first use */
+    Operand emit(Operation op, const Operand &a, const Operand &b); /**< appended to the preheader, folded when the operands allow it */
+
+    CFG *cfg;
+    Loop *loop;
+    BasicBlock *latch = nullptr;
+    BasicBlock *preheader;
+    bool valid;
+    unordered_set<int> definedInLoop;
+    unordered_map<int, IRInstr *> definitions;
+    unordered_map<int, Recurrence> recurrences; /**< of the variables of the loop whose evolution is known */
+    map<int, Evolution> evolutions; /**< of the phi instructions of the header that are induction variables or accumulators */
+};
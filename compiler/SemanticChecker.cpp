@@ -0,0 +1,122 @@
+#include "SemanticChecker.h"
+
+#include <algorithm>
+
+#include "CompileError.h"
+
+SemanticChecker::SemanticChecker(Arena *arena, Identifiers *identifiers, ostream &diagnostics) :
+    arena(arena), identifiers(identifiers), diagnostics(diagnostics)
+{
+}
+
+void SemanticChecker::add_function(int identifier, Type type, int arity)
+{
+    functions.add(identifier, identifiers->get_name(identifier), type, arity);
+}
+
+CFG *SemanticChecker::begin_function(int identifier)
+{
+    currentFunction = definitions++;
+    const string &name = identifiers->get_name(identifier);
+    if (functions.find(identifier)->index != currentFunction)
+    {
+        throw CompileError(4, "Fonction " + name + " already defined");
+    }
+    // chaque fonction a sa propre arène : les fonctions peuvent ensuite être optimisées en parallèle
+    Arena *functionArena = arena->create<Arena>();
+    cfg = functionArena->create<CFG>(name, functionArena);
+    return cfg;
+}
+
+void SemanticChecker::add_param(int identifier, int position)
+{
+    if (cfg->is_in_symbol_context(identifier))
+    {
+        throw CompileError(1, "Parameter defined more than once");
+    }
+    cfg->add_param_to_symbol_table(identifier, INT, position);
+}
+
+void SemanticChecker::check_main() const
+{
+    if (functions.find(identifiers->intern("main")) == nullptr)
+    {
+        throw CompileError(5, "Fonction main not defined");
+    }
+}
+
+Operand SemanticChecker::declare_variable(int identifier)
+{
+    if (cfg->is_in_symbol_context(identifier))
+    {
+        throw CompileError(1, "Redéfinition de la variable " + identifiers->get_name(identifier)); // variable déjà déclarée dans le contexte actuel
+    }
+    if (cfg->get_symbol_context_depth() == 2 && cfg->is_param(identifier))
+    {
+        throw CompileError(1, "Nom de variable existe déjà comme paramètre");
+    }
+    cfg->add_to_symbol_table(identifier, INT);
+    return Operand::variable(cfg->get_var_index(identifier));
+}
+
+void SemanticChecker::initialize_variable(int identifier)
+{
+    cfg->find_symbol(identifier)->status = 1;
+}
+
+Operand SemanticChecker::use_variable(int identifier)
+{
+    Symbol *symbol = cfg->find_symbol(identifier);
+    if (symbol == nullptr)
+    {
+        throw CompileError(2, "Variable " + identifiers->get_name(identifier) + " utilisée sans être déclarée"); // variable non déclarée
+    }
+    if (symbol->status == 0)
+    {
+        diagnostics << "Variable " << identifiers->get_name(identifier) << " utilisée sans être initialisée\n";
+    }
+    symbol->status = 2;
+    return Operand::variable(symbol->index);
+}
+
+Operand SemanticChecker::assign_variable(int identifier)
+{
+    Symbol *symbol = cfg->find_symbol(identifier);
+    if (symbol == nullptr)
+    {
+        throw CompileError(2, "Variable " + identifiers->get_name(identifier) + " utilisée sans être déclarée"); // variable non déclarée
+    }
+    symbol->status = max(1, symbol->status);
+    return Operand::variable(symbol->index);
+}
+
+void SemanticChecker::check_void_call(int callee) const
+{
+    // seules les fonctions déjà rencontrées, dont la fonction courante, sont connues
+    functions.check_void_call(callee, currentFunction);
+}
+
+const FunctionInfo *SemanticChecker::check_call(int callee, size_t arguments) const
+{
+    if (cfg->find_symbol(callee) != nullptr)
+    {
+        throw CompileError(1, "function name same as local var");
+    }
+    return functions.check_call(callee, arguments, currentFunction);
+}
+
+void SemanticChecker::end_symbol_context()
+{
+    vector<int> unused = cfg->get_unused_variables();
+    if (!unused.empty())
+    {
+        // par ordre alphabétique, quel que soit l'ordre des déclarations
+        vector<string> names;
+        for (int identifier : unused)
+            names.push_back(identifiers->get_name(identifier));
+        sort(names.begin(), names.end());
+        for (const string &name : names)
+            diagnostics << "Variable " << name << " inutilisée\n";
+    }
+    cfg->end_symbol_context();
+}
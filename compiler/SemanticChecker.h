@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ostream>
+
+#include "Arena.h"
+#include "CFG.h"
+#include "FunctionTable.h"
+#include "Identifiers.h"
+#include "Type.h"
+
+using namespace std;
+
+/** Checks of a program that the grammar cannot express, shared by both front ends
+
+   CToIRVisitor and NativeIRBuilder only walk their own tree: they call these checks with the
+   interned identifiers they meet, in the same order, so that both report the same errors and
+   warnings. Errors are thrown as CompileError with the exit status of ifcc, warnings are written to
+   diagnostics. The status of each variable (declared, initialised, used) is kept in the symbol table
+   of the CFG of the function being checked.
+*/
+class SemanticChecker {
+public:
+    SemanticChecker(Arena *arena, Identifiers *identifiers, ostream &diagnostics);
+
+    void add_function(int identifier, Type type, int arity); /**< header of a function, all are added before the first body */
+    CFG *begin_function(int identifier); /**< checks that the next function of the file is defined once and creates its CFG */
+    void add_param(int identifier, int position); /**< a parameter of the current function */
+    void check_main() const; /**< once every function is checked */
+
+    Operand declare_variable(int identifier); /**< a new variable of the innermost bloc */
+    void initialize_variable(int identifier); /**< a declaration with a value */
+    Operand use_variable(int identifier); /**< checks a variable read by an expression and returns it */
+    Operand assign_variable(int identifier); /**< checks a variable written by an affectation and returns it */
+    void check_void_call(int callee) const; /**< a call used as an operand: a void function may not be one */
+    const FunctionInfo *check_call(int callee, size_t arguments) const; /**< the callee if it is known here, nullptr for a library function */
+    void end_symbol_context(); /**< warns about the unused variables of the innermost bloc and leaves it */
+
+protected:
+    Arena *arena; /**< owns the arenas of the CFGs, one per function */
+    Identifiers *identifiers; /**< names of the variables and functions, for the messages */
+    ostream &diagnostics;
+    FunctionTable functions; /**< headers of all the functions of the file */
+    size_t definitions = 0; /**< number of functions whose body has been met */
+    size_t currentFunction = 0; /**< number of the function being checked, in source order */
+    CFG *cfg = nullptr; /**< CFG of the function being checked */
+};
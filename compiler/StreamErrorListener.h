@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ostream>
+
+#include "antlr4-runtime.h"
+
+using namespace std;
+
+/** ANTLR error listener writing the syntax errors of a file to a stream
+
+   Same format as antlr4::ConsoleErrorListener, which always writes to cerr: with ifcc --batch
+   every file collects its own diagnostics, which are printed once the file has been compiled.
+*/
+class StreamErrorListener : public antlr4::BaseErrorListener {
+public:
+    explicit StreamErrorListener(ostream &out) : out(out) {}
+
+    void syntaxError(antlr4::Recognizer *recognizer, antlr4::Token *offendingSymbol, size_t line,
+                     size_t charPositionInLine, const string &msg, exception_ptr e) override
+    {
+        out << "line " << line << ":" << charPositionInLine << " " << msg << endl;
+    }
+
+protected:
+    ostream &out;
+};
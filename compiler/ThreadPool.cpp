@@ -0,0 +1,44 @@
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ThreadPool::ThreadPool(int threadCount) : threadCount(threadCount < 1 ? 1 : threadCount) {}
+
+void ThreadPool::run(size_t taskCount, const function<void(size_t)> &task) const
+{
+    atomic<size_t> next(0);
+    exception_ptr error;
+    mutex errorMutex;
+
+    // chaque thread prend la prochaine tâche libre : les fonctions longues ne bloquent pas les autres
+    auto work = [&]()
+    {
+        for (size_t i = next++; i < taskCount; i = next++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(errorMutex);
+                if (!error)
+                    error = current_exception();
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 1; i < threadCount && (size_t)i < taskCount; i++)
+        threads.emplace_back(work);
+    work();
+    for (auto &t : threads)
+        t.join();
+
+    if (error)
+        rethrow_exception(error);
+}
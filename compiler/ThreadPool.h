@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+/** Runs independent tasks on a fixed number of threads
+
+   run(n, task) calls task(0) .. task(n - 1), each index exactly once, in no particular order,
+   and returns when all of them are done. The calling thread takes part in the work:
+   with a single thread the tasks are run in order, without creating any thread.
+   The first exception thrown by a task is rethrown by run().
+*/
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount);
+    void run(size_t taskCount, const function<void(size_t)> &task) const;
+
+protected:
+    int threadCount;
+};
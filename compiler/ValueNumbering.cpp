@@ -0,0 +1,225 @@
+#include "ValueNumbering.h"
+
+#include <algorithm>
+
+ValueNumbering::ValueNumbering(CFG *cfg) : cfg(cfg) {}
+
+size_t ValueNumbering::ExpressionHash::operator()(const Expression &expression) const
+{
+    size_t hash = expression.size();
+    for (long long element : expression)
+        hash = hash * 1000003 ^ std::hash<long long>()(element);
+    return hash;
+}
+
+int ValueNumbering::leader(int var) const
+{
+    auto it = replacements.find(var);
+    while (it != replacements.end())
+    {
+        var = it->second;
+        it = replacements.find(var);
+    }
+    return var;
+}
+
+long long ValueNumbering::valueOf(const Operand &operand) const
+{
+    // les immédiats sont impairs, les variables paires
+    if (operand.is_immediate())
+        return 2 * (long long)operand.get_value() + 1;
+    return 2 * (long long)leader(operand.get_index());
+}
+
+bool ValueNumbering::makeExpression(const IRInstr *instr, BasicBlock *bb, Expression &expression) const
+{
+    Operation op = instr->op;
+    switch (op)
+    {
+    case ldconst:
+    case copyvar:
+        // une copie d'un immédiat est un chargement de constante
+        expression = {ldconst, valueOf(instr->params[1])};
+        return true;
+    case neg:
+    case lnot:
+    case bwnot:
+    case incr:
+    case decr:
+        expression = {op, valueOf(instr->params.back())};
+        return true;
+    case phi:
+    {
+        // les phi d'un même bloc dont les opérandes ont les mêmes valeurs par les mêmes arcs
+        vector<pair<long long, long long>> operands;
+        for (unsigned long i = 1; i < instr->params.size(); i += 2)
+            operands.emplace_back(blockNumbers.at(instr->params[i].get_block()), valueOf(instr->params[i + 1]));
+        sort(operands.begin(), operands.end());
+        expression = {op, blockNumbers.at(bb)};
+        for (auto &operand : operands)
+        {
+            expression.push_back(operand.first);
+            expression.push_back(operand.second);
+        }
+        return true;
+    }
+    case add:
+    case sub:
+    case mul:
+    case divide:
+    case modulo:
+    case bwor:
+    case bwand:
+    case bwxor:
+    case bwsl:
+    case bwsr:
+    case cmp_eq:
+    case cmp_ne:
+    case cmp_lt:
+    case cmp_le:
+    case cmp_gt:
+    case cmp_ge:
+    {
+        long long a = valueOf(instr->params[1]);
+        long long b = valueOf(instr->params[2]);
+        // forme canonique : opérandes triés, les comparaisons d'ordre retournées si besoin
+        if (a > b)
+        {
+            switch (op)
+            {
+            case add:
+            case mul:
+            case bwor:
+            case bwand:
+            case bwxor:
+            case cmp_eq:
+            case cmp_ne:
+            case cmp_lt:
+            case cmp_le:
+            case cmp_gt:
+            case cmp_ge:
+                op = mirrored(op);
+                swap(a, b);
+                break;
+            default:
+                break;
+            }
+        }
+        expression = {op, a, b};
+        return true;
+    }
+    default:
+        // appels, retours, sauts, accès mémoire
+        return false;
+    }
+}
+
+int ValueNumbering::eliminate(const DominatorTree &tree)
+{
+    for (unsigned long i = 0; i < cfg->bbs->size(); i++)
+        blockNumbers[(*cfg->bbs)[i]] = i;
+
+    // parcours en profondeur itératif de l'arbre des dominateurs, comme SSA::rename :
+    // les expressions d'un bloc ne sont disponibles que dans son sous-arbre
+    vector<pair<BasicBlock *, vector<Expression>>> stack;
+    vector<unsigned long> nextChild;
+    stack.emplace_back(cfg->bbs->front(), vector<Expression>());
+    nextChild.push_back(0);
+
+    int removed = 0;
+    bool enter = true;
+    while (!stack.empty())
+    {
+        BasicBlock *bb = stack.back().first;
+        vector<Expression> &inserted = stack.back().second;
+
+        if (enter)
+        {
+            vector<IRInstr *> kept;
+            for (auto instr : *bb->instrs)
+            {
+                int defined = instr->get_defined_var();
+                if (defined == 0 || instr->op == call)
+                {
+                    kept.push_back(instr);
+                    continue;
+                }
+
+                // une copie, ou un phi dont tous les opérandes (hors lui-même) ont la même valeur, n'est qu'un autre nom
+                int same = 0;
+                if (instr->op == copyvar && instr->params[1].is_variable())
+                    same = leader(instr->params[1].get_index());
+                else if (instr->op == phi)
+                    for (unsigned long i = 2; i < instr->params.size(); i += 2)
+                    {
+                        if (!instr->params[i].is_variable())
+                        {
+                            same = 0;
+                            break;
+                        }
+                        int var = leader(instr->params[i].get_index());
+                        if (var == defined)
+                            continue;
+                        if (same != 0 && same != var)
+                        {
+                            same = 0;
+                            break;
+                        }
+                        same = var;
+                    }
+                if (same != 0)
+                {
+                    replacements[defined] = same;
+                    removed++;
+                    continue;
+                }
+
+                Expression expression;
+                if (!makeExpression(instr, bb, expression))
+                {
+                    kept.push_back(instr);
+                    continue;
+                }
+                auto found = available.find(expression);
+                if (found != available.end())
+                {
+                    replacements[defined] = found->second;
+                    removed++;
+                    continue;
+                }
+                available.emplace(expression, defined);
+                inserted.push_back(expression);
+                kept.push_back(instr);
+            }
+            bb->instrs->assign(kept.begin(), kept.end());
+        }
+
+        const vector<BasicBlock *> &children = tree.get_children(bb);
+        if (nextChild.back() < children.size())
+        {
+            stack.emplace_back(children[nextChild.back()++], vector<Expression>());
+            nextChild.push_back(0);
+            enter = true;
+            continue;
+        }
+
+        for (auto &expression : inserted)
+            available.erase(expression);
+        stack.pop_back();
+        nextChild.pop_back();
+        enter = false;
+    }
+
+    // les lectures des variables supprimées, y compris par les phi des arcs retour et les tests de fin de bloc
+    if (removed != 0)
+        for (auto bb : *cfg->bbs)
+        {
+            for (auto instr : *bb->instrs)
+                for (unsigned long i : instr->get_source_indices())
+                    if (instr->params[i].is_variable())
+                        instr->params[i] = Operand::variable(leader(instr->params[i].get_index()));
+            if (bb->exit_false != nullptr)
+                bb->test_var_index = leader(bb->test_var_index);
+        }
+    return removed;
+}
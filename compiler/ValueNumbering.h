@@ -0,0 +1,47 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "CFG.h"
+#include "DominatorTree.h"
+
+using namespace std;
+
+/** Dominator-based global value numbering of a CFG in SSA form (Briggs, Cooper and Simpson)
+
+   The blocks are visited in preorder of the dominator tree with a scoped table of the expressions
+   computed so far: an expression already computed in a dominating block, or earlier in the block,
+   is redundant. Its instruction is removed and its variable is replaced by the earlier one in the
+   whole function, which SSA form makes sound (the earlier definition dominates every use).
+   An expression is an operation and the values of its operands: an immediate, or for a variable
+   the variable its value was first computed in. The operands of add, mul, bwand, bwor, bwxor,
+   cmp_eq and cmp_ne are sorted, cmp_lt and cmp_gt (cmp_le and cmp_ge) are mirrored into each other:
+   b + a and b > a are the same values as a + b and a < b.
+   Copies, and phi instructions whose operands all have the same value, are removed the same way.
+   Calls are never redundant.
+
+   The CFG must be in SSA form (see SSA::build) and tree must be its dominator tree.
+*/
+class ValueNumbering
+{
+public:
+    explicit ValueNumbering(CFG *cfg);
+    int eliminate(const DominatorTree &tree); /**< number of instructions removed */
+
+protected:
+    typedef vector<long long> Expression;
+    struct ExpressionHash
+    {
+        size_t operator()(const Expression &expression) const;
+    };
+
+    bool makeExpression(const IRInstr *instr, BasicBlock *bb, Expression &expression) const; /**< false for the instructions that cannot be redundant */
+    long long valueOf(const Operand &operand) const;
+    int leader(int var) const; /**< variable holding the value of var */
+
+    CFG *cfg;
+    unordered_map<BasicBlock *, int> blockNumbers;
+    unordered_map<int, int> replacements; /**< removed variable -> the variable holding its value */
+    unordered_map<Expression, int, ExpressionHash> available; /**< expressions of the dominating blocks -> variable holding their value */
+};
@@ -7,55 +7,274 @@
 #include "generated/ifccLexer.h"
 #include "generated/ifccParser.h"
 
-#include "ValidatorVisitor.h"
 #include "CToIRVisitor.h"
+#include "NativeParser.h"
+#include "NativeIRBuilder.h"
 #include "IROptimizer.h"
+#include "RegisterAllocator.h"
+#include "Arena.h"
+#include "ThreadPool.h"
+#include "CompileError.h"
+#include "StreamErrorListener.h"
 
 using namespace antlr4;
 using namespace std;
 
-int main(int argn, const char **argv)
-{
-    stringstream in;
-    if (argn==2) {
-        ifstream lecture(argv[1]);
-        if (!lecture.good()) {
-            cerr<<"error: cannot read file: " << argv[1] << endl ;
-            exit(1);
-        }
-        in << lecture.rdbuf();
-    } else {
-        cerr << "usage: ifcc path/to/file.c" << endl ;
-        exit(1);
-    }
+/** One file of ifcc --batch, with what its compilation reported */
+struct BatchEntry {
+    string sourceFile;
+    string outputFile;
+    int status = 0;
+    ostringstream diagnostics;
+};
 
-    ANTLRInputStream input(in.str());
+/** Options of the command line shared by all the files compiled */
+struct CompileOptions {
+    int optimizationLevel = 1;
+    int jobs = 1;
+    bool twoStageParsing = true; /**< parse in SLL mode first, and in full LL only if it fails (--prediction=ll turns it off) */
+    bool nativeFrontend = false; /**< --frontend=native: NativeParser and NativeIRBuilder instead of ANTLR and the visitors */
+    chrono::milliseconds passBudget = IROptimizer::defaultPassBudget; /**< --pass-budget=MS, see PassManager */
+    bool reportPasses = false; /**< --report-passes: statistics of the optimization passes on diagnostics */
+    PassSettings passSettings; /**< --unroll=N */
+    bool remarks = false; /**< --remarks: what the passes did to each loop, on diagnostics */
+};
+
+/** ANTLR front end: parses the source, then checks it and generates its IR with CToIRVisitor */
+static vector<CFG *> *antlrFrontend(const string &source, Arena *arena, ostream &diagnostics, bool twoStageParsing)
+{
+    ANTLRInputStream input(source);
+    StreamErrorListener errorListener(diagnostics);
 
     ifccLexer lexer(&input);
+    lexer.removeErrorListeners();
+    lexer.addErrorListener(&errorListener);
     CommonTokenStream tokens(&lexer);
 
     tokens.fill();
 
+    // analyse en deux temps : la prédiction SLL, bien plus rapide sur les expressions, suffit presque toujours ;
+    // elle abandonne à la première erreur sans rien afficher, et on ne refait alors l'analyse en LL complet
+    // (qui produit les messages d'erreur habituels) que dans ce cas
     ifccParser parser(&tokens);
-    tree::ParseTree* tree = parser.axiom();
+    parser.removeErrorListeners();
+    tree::ParseTree* tree = nullptr;
+    if (twoStageParsing) {
+        parser.getInterpreter<atn::ParserATNSimulator>()->setPredictionMode(atn::PredictionMode::SLL);
+        parser.setErrorHandler(make_shared<BailErrorStrategy>());
+        try {
+            tree = parser.axiom();
+        } catch (const ParseCancellationException &) {
+            parser.reset();
+            parser.getInterpreter<atn::ParserATNSimulator>()->setPredictionMode(atn::PredictionMode::LL);
+            parser.setErrorHandler(make_shared<DefaultErrorStrategy>());
+        }
+    }
+    if (tree == nullptr) {
+        parser.addErrorListener(&errorListener);
+        tree = parser.axiom();
+    }
 
     if(parser.getNumberOfSyntaxErrors() != 0) {
-        cerr << "error: syntax error during parsing" << endl;
-        exit(1);
+        throw CompileError(1, "error: syntax error during parsing");
     }
 
-    ValidatorVisitor vv;
-    vv.visit(tree);
-
-    CToIRVisitor v(vv.definedFunctions);
+    CToIRVisitor v(arena, diagnostics);
     v.visit(tree);
-  
+    return v.cfgs;
+}
 
-    IROptimizer iro(v.cfgs);
-    iro.optimize();
+/** Native front end: the whole file is parsed into a syntax tree, then checked and translated in a single walk */
+static vector<CFG *> *nativeFrontend(const string &source, Arena *arena, ostream &diagnostics)
+{
+    Identifiers *identifiers = arena->create<Identifiers>();
+    AstProgram *program = NativeParser(source, arena, identifiers, diagnostics).parse();
+    return NativeIRBuilder(arena, identifiers, diagnostics).build(program);
+}
+
+/** Compiles a C source, writes its assembly to out and returns the exit status of ifcc for it.
+   Warnings and errors go to diagnostics; on error nothing is written to out. */
+static int compile(const string &source, ostream &out, ostream &diagnostics, const CompileOptions &options)
+{
+    try {
+        // tout l'IR du fichier (et l'arbre du front end natif) est alloué dans cette arène, libérée d'un bloc à la fin
+        Arena arena;
+        vector<CFG *> *cfgs = options.nativeFrontend ? nativeFrontend(source, &arena, diagnostics)
+                                                     : antlrFrontend(source, &arena, diagnostics, options.twoStageParsing);
 
-    for (auto cfg : *v.cfgs)
-        cfg->gen_asm(cout);
+        // les fonctions sont indépendantes : chacune est optimisée et traduite dans son propre tampon,
+        // les tampons sont ensuite écrits dans l'ordre du source (sortie identique quel que soit -j)
+        IROptimizer iro(cfgs, options.optimizationLevel, options.passBudget, options.passSettings);
+        vector<ostringstream> outputs(cfgs->size());
+        vector<ostringstream> remarks(cfgs->size());
+        ThreadPool(options.jobs).run(cfgs->size(), [&](size_t i) {
+            CFG *cfg = (*cfgs)[i];
+            iro.optimizeFunction(cfg, options.remarks ? &remarks[i] : nullptr);
+            if (options.optimizationLevel >= 2)
+                RegisterAllocator(cfg).allocate();
+            cfg->gen_asm(outputs[i]);
+        });
+
+        for (auto &output : outputs)
+            out << output.str();
+        for (auto &remark : remarks)
+            diagnostics << remark.str();
+        if (options.reportPasses)
+            iro.report(diagnostics);
+        return 0;
+    } catch (const CompileError &e) {
+        diagnostics << e.what() << endl;
+        return e.get_status();
+    } catch (const exception &e) {
+        diagnostics << "internal error: " << e.what() << endl;
+        return 1;
+    }
+}
+
+/** Adds the entries "in.c:out.s" of the command line (or, for @manifest, one per line of the file) to the batch */
+static bool addBatchEntries(const string &arg, vector<BatchEntry> &entries)
+{
+    vector<string> specs;
+    if (arg[0] == '@') {
+        ifstream manifest(arg.substr(1));
+        if (!manifest.good())
+            return false;
+        string line;
+        while (getline(manifest, line)) {
+            if (!line.empty() && line[0] != '#')
+                specs.push_back(line);
+        }
+    } else {
+        specs.push_back(arg);
+    }
+    for (const string &spec : specs) {
+        size_t colon = spec.rfind(':');
+        if (colon == string::npos || colon == 0 || colon + 1 == spec.size())
+            return false;
+        entries.emplace_back();
+        entries.back().sourceFile = spec.substr(0, colon);
+        entries.back().outputFile = spec.substr(colon + 1);
+    }
+    return true;
+}
+
+/** ifcc --batch: the files are spread over the threads and share the warm DFA cache of the ANTLR parser,
+   each one gets its own status instead of stopping the whole process */
+static int compileBatch(vector<BatchEntry> &entries, const CompileOptions &options)
+{
+    // dans un lot, les threads compilent chacun un fichier, les fonctions d'un fichier restent séquentielles
+    CompileOptions fileOptions = options;
+    fileOptions.jobs = 1;
+    ThreadPool(options.jobs).run(entries.size(), [&](size_t i) {
+        BatchEntry &entry = entries[i];
+        ifstream lecture(entry.sourceFile);
+        if (!lecture.good()) {
+            entry.diagnostics << "error: cannot read file: " << entry.sourceFile << endl;
+            entry.status = 1;
+            return;
+        }
+        stringstream in;
+        in << lecture.rdbuf();
+        ostringstream out;
+        entry.status = compile(in.str(), out, entry.diagnostics, fileOptions);
+        if (entry.status == 0) {
+            ofstream output(entry.outputFile);
+            output << out.str();
+            if (!output.good()) {
+                entry.diagnostics << "error: cannot write file: " << entry.outputFile << endl;
+                entry.status = 1;
+            }
+        }
+    });
+
+    int failed = 0;
+    for (BatchEntry &entry : entries) {
+        istringstream diagnostics(entry.diagnostics.str());
+        string line;
+        while (getline(diagnostics, line))
+            cerr << entry.sourceFile << ": " << line << "\n";
+        cout << entry.sourceFile << ": exit status " << entry.status << "\n";
+        if (entry.status != 0)
+            failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argn, const char **argv)
+{
+    stringstream in;
+    const char *sourceFile = nullptr;
+    CompileOptions options;
+    bool batch = false;
+    bool usage = false;
+    vector<BatchEntry> entries;
+    for (int i = 1; i < argn && !usage; i++) {
+        string arg = argv[i];
+        if (arg.size() == 3 && arg.rfind("-O", 0) == 0 && isdigit(arg[2])) {
+            options.optimizationLevel = arg[2] - '0';
+        } else if (arg.rfind("-j", 0) == 0) {
+            // -j N ou -jN : nombre de fonctions (ou de fichiers avec --batch) traitées en parallèle
+            string count = arg.size() > 2 ? arg.substr(2) : (i + 1 < argn ? argv[++i] : "");
+            if (count.empty() || count.size() > 4 || count.find_first_not_of("0123456789") != string::npos || stoi(count) < 1) {
+                usage = true;
+            } else {
+                options.jobs = stoi(count);
+            }
+        } else if (arg == "--prediction=ll") {
+            // analyse directement en LL complet, pour comparer avec l'analyse en deux temps
+            options.twoStageParsing = false;
+        } else if (arg == "--prediction=sll") {
+            options.twoStageParsing = true;
+        } else if (arg == "--frontend=native") {
+            options.nativeFrontend = true;
+        } else if (arg == "--frontend=antlr") {
+            options.nativeFrontend = false;
+        } else if (arg.rfind("--pass-budget=", 0) == 0) {
+            // temps maximal de chaque passe d'optimisation sur une fonction, en millisecondes (0 : pas de limite)
+            string budget = arg.substr(14);
+            if (budget.empty() || budget.size() > 6 || budget.find_first_not_of("0123456789") != string::npos) {
+                usage = true;
+            } else {
+                options.passBudget = chrono::milliseconds(stoi(budget));
+            }
+        } else if (arg.rfind("--unroll=", 0) == 0) {
+            // nombre de copies du corps d'une boucle comptée par tour déroulé (1 : pas de déroulage)
+            string factor = arg.substr(9);
+            if (factor.empty() || factor.size() > 2 || factor.find_first_not_of("0123456789") != string::npos || stoi(factor) < 1) {
+                usage = true;
+            } else {
+                options.passSettings.unrollFactor = stoi(factor);
+            }
+        } else if (arg == "--remarks") {
+            options.remarks = true;
+        } else if (arg == "--report-passes") {
+            options.reportPasses = true;
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (batch) {
+            usage = !addBatchEntries(arg, entries);
+        } else if (sourceFile == nullptr) {
+            sourceFile = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+    if (usage || (batch ? sourceFile != nullptr || entries.empty() : sourceFile == nullptr)) {
+        cerr << "usage: ifcc [-O0|-O1|-O2] [-j N] [--prediction=sll|ll] [--frontend=antlr|native] [--pass-budget=MS] [--unroll=N] [--report-passes] [--remarks] path/to/file.c" << endl ;
+        cerr << "       ifcc [-O0|-O1|-O2] [-j N] [--prediction=sll|ll] [--frontend=antlr|native] [--pass-budget=MS] [--unroll=N] [--report-passes] [--remarks] --batch in.c:out.s|@manifest..." << endl ;
+        exit(1);
+    }
+
+    if (batch) {
+        return compileBatch(entries, options);
+    }
+
+    ifstream lecture(sourceFile);
+    if (!lecture.good()) {
+        cerr<<"error: cannot read file: " << sourceFile << endl ;
+        exit(1);
+    }
+    in << lecture.rdbuf();
 
-    return 0;
+    return compile(in.str(), cout, cerr, options);
 }
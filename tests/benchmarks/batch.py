@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+# Compare le débit (fichiers par seconde) d'un processus ifcc par fichier, comme ifcc-wrapper.sh,
+# avec un seul processus `ifcc --batch`, et vérifie que les deux produisent le même code et les mêmes statuts.
+#
+# usage : python3 batch.py [--ifcc ../../compiler/ifcc] [--flags=-O2] [-j N] [--repeat R] [PATH...]
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+from common import HERE, argument_parser, sources
+
+
+def main():
+    parser = argument_parser('measure the throughput of ifcc --batch')
+    parser.add_argument('paths', metavar='PATH', nargs='*', default=[os.path.join(HERE, '..', 'testfiles')])
+    parser.add_argument('--flags', default='', help='options given to ifcc, e.g. -O2')
+    parser.add_argument('-j', type=int, default=os.cpu_count(), help='threads of ifcc --batch')
+    parser.add_argument('--repeat', type=int, default=1, help='compile every file R times')
+    args = parser.parse_args()
+
+    files = sources(args.paths) * args.repeat
+    flags = args.flags.split()
+    with tempfile.TemporaryDirectory() as tmp:
+        # un processus par fichier
+        start = time.perf_counter()
+        single = []
+        for i, source in enumerate(files):
+            with open(os.path.join(tmp, 'single%d.s' % i), 'w') as out:
+                single.append(subprocess.run([args.ifcc] + flags + [source], stdout=out, stderr=subprocess.DEVNULL).returncode)
+        single_time = time.perf_counter() - start
+
+        # un seul processus, fichiers listés dans un manifeste
+        manifest = os.path.join(tmp, 'manifest')
+        with open(manifest, 'w') as m:
+            for i, source in enumerate(files):
+                m.write('%s:%s\n' % (source, os.path.join(tmp, 'batch%d.s' % i)))
+        start = time.perf_counter()
+        result = subprocess.run([args.ifcc] + flags + ['-j', str(args.j), '--batch', '@' + manifest],
+                                stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+        batch_time = time.perf_counter() - start
+        batch = [int(line.rsplit(' ', 1)[1]) for line in result.stdout.splitlines()]
+
+        mismatches = 0
+        for i, source in enumerate(files):
+            same = single[i] == batch[i]
+            if same and single[i] == 0:
+                with open(os.path.join(tmp, 'single%d.s' % i)) as a, open(os.path.join(tmp, 'batch%d.s' % i)) as b:
+                    same = a.read() == b.read()
+            if not same:
+                mismatches += 1
+                print('mismatch: ' + source)
+
+    print('%d files, %d rejected' % (len(files), sum(1 for status in single if status != 0)))
+    print('one process per file : %.2fs, %.1f files/s' % (single_time, len(files) / single_time))
+    print('ifcc --batch -j %-4d : %.2fs, %.1f files/s (x%.1f)' % (args.j, batch_time, len(files) / batch_time, single_time / batch_time))
+    return 1 if mismatches else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+
+# Mesure le passage à l'échelle du compilateur avec le nombre de blocs de base d'une fonction : une seule
+# fonction faite d'une longue suite de if/else et de boucles. Le temps par bloc doit rester à peu près constant
+# quand leur nombre double (nettoyage du CFG en temps linéaire).
+#
+# usage : python3 blocks.py [--ifcc ../../compiler/ifcc] [--counts 1000,2000,...] [--flags -O0] [--repeat R]
+
+import sys
+import tempfile
+
+from common import argument_parser, timed
+
+
+def program(count):
+    source = 'int main() {\n    int a = 1, b = 2;\n'
+    for i in range(count):
+        source += '    if (a < %d) {\n        b = b + a;\n    } else {\n        a = a + 1;\n    }\n' % i
+        if i % 4 == 0:
+            source += '    while (a < %d) {\n        a = a + 2;\n    }\n' % (i + 3)
+    source += '    return (a + b) & 255;\n}\n'
+    return source
+
+
+def main():
+    parser = argument_parser('measure how ifcc scales with the number of basic blocks of a function')
+    parser.add_argument('--counts', default='1000,2000,4000,8000', help='numbers of if statements in the function')
+    parser.add_argument('--flags', default='-O0', help='optimization level, and any other option of ifcc')
+    parser.add_argument('--repeat', type=int, default=3, help='keep the best of R runs')
+    args = parser.parse_args()
+
+    print('%8s %10s %10s' % ('ifs', 'time (s)', 'us / if'))
+    for count in [int(count) for count in args.counts.split(',')]:
+        with tempfile.NamedTemporaryFile('w', suffix='.c') as source:
+            source.write(program(count))
+            source.flush()
+            elapsed, result = timed([args.ifcc] + args.flags.split() + [source.name], args.repeat)
+        if result.returncode != 0:
+            sys.stderr.write(result.stderr.decode(errors='replace'))
+            print('error: ifcc failed on %d if statements' % count)
+            return 1
+        print('%8d %10.3f %10.1f' % (count, elapsed, elapsed / count * 1e6))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,39 @@
+# Fonctions communes aux scripts de mesure de ce dossier (importées, pas lancées).
+
+import argparse
+import os
+import subprocess
+import time
+
+HERE = os.path.dirname(os.path.realpath(__file__))
+
+
+def argument_parser(description):
+    """parser of the command line of a benchmark, with the --ifcc option shared by all of them"""
+    parser = argparse.ArgumentParser(description=description)
+    parser.add_argument('--ifcc', default=os.path.join(HERE, '..', '..', 'compiler', 'ifcc'))
+    return parser
+
+
+def sources(paths):
+    """the .c files of the paths, those of a directory and its subdirectories in sorted order"""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for dirpath, dirnames, filenames in os.walk(path):
+                dirnames.sort()
+                files += [os.path.join(dirpath, name) for name in sorted(filenames) if name.endswith('.c')]
+        else:
+            files.append(path)
+    return files
+
+
+def timed(command, repeat, stdout=subprocess.DEVNULL):
+    """best time of R runs of the command, with the result of the last one (stderr is always kept)"""
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = subprocess.run(command, stdout=stdout, stderr=subprocess.PIPE)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, result
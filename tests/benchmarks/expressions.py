@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+
+# Mesure l'analyse syntaxique sur des expressions profondes (parenthèses imbriquées) et longues (chaînes
+# d'opérateurs binaires) : compare l'analyse en deux temps SLL puis LL (par défaut) à l'analyse en LL complet
+# (--prediction=ll), et vérifie que les deux produisent le même code.
+#
+# usage : python3 expressions.py [--ifcc ../../compiler/ifcc] [--depth D] [--length L] [--functions F] [--repeat R]
+
+import random
+import subprocess
+import sys
+import tempfile
+
+from common import argument_parser, timed
+
+OPERATORS = ['+', '-', '*', '&', '|', '^', '<', '==', '!=', '&&', '||', '<<', '>>']
+
+
+def deep(rng, depth):
+    expression = 'a'
+    for _ in range(depth):
+        expression = '(' + expression + ' ' + rng.choice(OPERATORS) + ' ' + rng.choice(['a', 'b', str(rng.randint(0, 9))]) + ')'
+    return expression
+
+
+def chain(rng, length):
+    terms = [rng.choice(['a', 'b', str(rng.randint(0, 9))]) for _ in range(length + 1)]
+    return ' '.join(term + ' ' + rng.choice(OPERATORS) for term in terms[:-1]) + ' ' + terms[-1]
+
+
+def program(rng, depth, length, functions):
+    source = ''
+    for f in range(functions):
+        source += 'int f%d(int a, int b) {\n' % f
+        source += '    int x = ' + deep(rng, depth) + ';\n'
+        source += '    int y = ' + chain(rng, length) + ';\n'
+        source += '    return x + y;\n}\n\n'
+    source += 'int main() {\n    return f0(1, 2);\n}\n'
+    return source
+
+
+def main():
+    parser = argument_parser('measure two-stage SLL/LL parsing on deep and long expressions')
+    parser.add_argument('--depth', type=int, default=100, help='nesting depth of the deep expressions')
+    parser.add_argument('--length', type=int, default=500, help='number of operators of the long expressions')
+    parser.add_argument('--functions', type=int, default=50)
+    parser.add_argument('--repeat', type=int, default=3, help='keep the best of R runs')
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    with tempfile.NamedTemporaryFile('w', suffix='.c') as source:
+        source.write(program(random.Random(args.seed), args.depth, args.length, args.functions))
+        source.flush()
+        ll_time, ll = timed([args.ifcc, '-O0', '--prediction=ll', source.name], args.repeat, stdout=subprocess.PIPE)
+        sll_time, sll = timed([args.ifcc, '-O0', source.name], args.repeat, stdout=subprocess.PIPE)
+
+    print('%d functions, depth %d, length %d' % (args.functions, args.depth, args.length))
+    print('full LL     : %.3fs' % ll_time)
+    print('SLL then LL : %.3fs (x%.2f)' % (sll_time, ll_time / sll_time))
+    if (ll.returncode, ll.stdout, ll.stderr) != (sll.returncode, sll.stdout, sll.stderr):
+        print('error: the two parsing strategies give different results')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+# Compare le front end ANTLR avec le front end natif (--frontend=native) sur un gros programme produit
+# par generate.py : temps de compilation en -O0 et mémoire maximale du processus (le reste du compilateur
+# est le même pour les deux, la différence est celle des front ends).
+# Vérifie aussi que les deux front ends produisent le même code.
+#
+# usage : python3 frontend.py [--ifcc ../../compiler/ifcc] [--functions N] [--statements M] [--repeat R]
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+from common import HERE, argument_parser
+
+
+def measured(command, repeat):
+    """best time and peak resident memory (in KiB) of R runs of the command, with its result"""
+    best_time = best_memory = None
+    for _ in range(repeat):
+        with tempfile.TemporaryFile() as stdout, tempfile.TemporaryFile() as stderr:
+            start = time.perf_counter()
+            process = subprocess.Popen(command, stdout=stdout, stderr=stderr)
+            # wait4 donne la mémoire de ce seul processus (RUSAGE_CHILDREN garde le maximum de tous)
+            _, status, usage = os.wait4(process.pid, 0)
+            elapsed = time.perf_counter() - start
+            process.returncode = os.waitstatus_to_exitcode(status)
+            stdout.seek(0)
+            stderr.seek(0)
+            result = (process.returncode, stdout.read(), stderr.read())
+        best_time = elapsed if best_time is None else min(best_time, elapsed)
+        best_memory = usage.ru_maxrss if best_memory is None else min(best_memory, usage.ru_maxrss)
+    return best_time, best_memory, result
+
+
+def main():
+    parser = argument_parser('compare the ANTLR and native front ends of ifcc')
+    parser.add_argument('--functions', type=int, default=2000)
+    parser.add_argument('--statements', type=int, default=100)
+    parser.add_argument('--repeat', type=int, default=3, help='keep the best of R runs')
+    args = parser.parse_args()
+
+    with tempfile.NamedTemporaryFile('w', suffix='.c') as source:
+        subprocess.run([sys.executable, os.path.join(HERE, 'generate.py'), '--functions', str(args.functions),
+                        '--statements', str(args.statements)], stdout=source, check=True)
+        source.flush()
+        size = os.path.getsize(source.name)
+        antlr_time, antlr_memory, antlr = measured([args.ifcc, '-O0', source.name], args.repeat)
+        native_time, native_memory, native = measured([args.ifcc, '-O0', '--frontend=native', source.name], args.repeat)
+
+    print('%.1f MB of source, -O0' % (size / 1e6))
+    print('antlr  : %.3fs, %d MB' % (antlr_time, antlr_memory // 1024))
+    print('native : %.3fs, %d MB (time x%.1f, memory x%.1f)' % (native_time, native_memory // 1024,
+                                                               antlr_time / native_time, antlr_memory / max(native_memory, 1)))
+    if antlr != native:
+        print('error: the two front ends give different results')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
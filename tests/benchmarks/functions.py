@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+# Mesure le passage à l'échelle du compilateur avec le nombre de fonctions d'un fichier : chaque fonction,
+# petite, appelle quelques fonctions du fichier et une de la bibliothèque. Le temps par fonction doit rester
+# à peu près constant quand le nombre de fonctions double (recherche des fonctions en temps constant).
+#
+# usage : python3 functions.py [--ifcc ../../compiler/ifcc] [--counts 2000,4000,...] [--frontend antlr|native] [--repeat R]
+
+import random
+import sys
+import tempfile
+
+from common import argument_parser, timed
+
+
+def program(count, rng):
+    source = ''
+    for f in range(count):
+        source += 'int f%d(int a, int b) {\n' % f
+        source += '    int c = a + b;\n'
+        for _ in range(3):
+            if f > 0:
+                source += '    c = c + f%d(c, a);\n' % rng.randrange(f)
+        source += '    putchar(c & 127);\n'
+        source += '    return c;\n}\n\n'
+    source += 'int main() {\n    return f%d(1, 2);\n}\n' % (count - 1)
+    return source
+
+
+def main():
+    parser = argument_parser('measure how ifcc scales with the number of functions of a file')
+    parser.add_argument('--counts', default='1000,2000,4000,8000,16000', help='numbers of functions to compile')
+    parser.add_argument('--frontend', default='native', choices=['antlr', 'native'])
+    parser.add_argument('--repeat', type=int, default=3, help='keep the best of R runs')
+    args = parser.parse_args()
+
+    print('%8s %10s %14s' % ('functions', 'time (s)', 'us / function'))
+    for count in [int(count) for count in args.counts.split(',')]:
+        with tempfile.NamedTemporaryFile('w', suffix='.c') as source:
+            source.write(program(count, random.Random(count)))
+            source.flush()
+            elapsed, result = timed([args.ifcc, '-O0', '--frontend=' + args.frontend, source.name], args.repeat)
+        if result.returncode != 0:
+            sys.stderr.write(result.stderr.decode(errors='replace'))
+            print('error: ifcc failed on %d functions' % count)
+            return 1
+        print('%8d %10.3f %14.1f' % (count, elapsed, elapsed / count * 1e6))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Génère un gros programme C synthétique (mais valide pour ifcc) pour mesurer le compilateur.
+#
+# usage : python3 generate.py [--functions N] [--statements M] [--seed S] > big.c
+
+import argparse
+import random
+
+
+def expression(rng, variables, depth):
+    if depth == 0 or rng.random() < 0.3:
+        if rng.random() < 0.6:
+            return rng.choice(variables)
+        return str(rng.randint(0, 100))
+    op = rng.choice(['+', '-', '*', '&', '|', '^', '<', '==', '&&', '||'])
+    return '(' + expression(rng, variables, depth - 1) + ' ' + op + ' ' + expression(rng, variables, depth - 1) + ')'
+
+
+def statement(rng, variables, callees, indent):
+    target = rng.choice(variables)
+    kind = rng.random()
+    if kind < 0.5:
+        return indent + target + ' = ' + expression(rng, variables, 3) + ';\n'
+    if kind < 0.65 and callees:
+        callee = rng.choice(callees)
+        return indent + target + ' = ' + callee + '(' + rng.choice(variables) + ', ' + rng.choice(variables) + ');\n'
+    if kind < 0.85:
+        return (indent + 'if (' + expression(rng, variables, 2) + ') {\n'
+                + indent + '    ' + target + ' = ' + expression(rng, variables, 2) + ';\n'
+                + indent + '} else {\n'
+                + indent + '    ' + target + ' += 1;\n'
+                + indent + '}\n')
+    return (indent + 'for (int i = 0; i < ' + str(rng.randint(1, 8)) + '; i++) {\n'
+            + indent + '    ' + target + ' = ' + expression(rng, variables + ['i'], 2) + ';\n'
+            + indent + '}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='generate a large synthetic C program')
+    parser.add_argument('--functions', type=int, default=200)
+    parser.add_argument('--statements', type=int, default=100)
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    names = []
+    for f in range(args.functions):
+        name = 'f' + str(f)
+        variables = ['a', 'b', 'c', 'd']
+        out = 'int ' + name + '(int a, int b) {\n'
+        out += '    int c = a + 1, d = b - 1;\n'
+        for _ in range(args.statements):
+            out += statement(rng, variables, names[-8:], '    ')
+        out += '    return (a + b + c + d) & 255;\n'
+        out += '}\n\n'
+        print(out, end='')
+        names.append(name)
+
+    print('int main() {')
+    print('    return ' + (names[-1] + '(1, 2)' if names else '0') + ';')
+    print('}')
+
+
+if __name__ == '__main__':
+    main()
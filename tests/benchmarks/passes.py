@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+
+# Compile tout un corpus (par défaut les fichiers de test) en un seul processus `ifcc --batch --report-passes`
+# et additionne les statistiques des passes de tous les fichiers : pour une passe qui supprime des instructions
+# (dce, gvn, ssa-dce...), la colonne `changes` est le nombre d'instructions supprimées sur tout le corpus.
+#
+# usage : python3 passes.py [--ifcc ../../compiler/ifcc] [--flags=-O2] [PATH...]
+
+import os
+import subprocess
+import sys
+import tempfile
+
+from common import HERE, argument_parser, sources
+
+
+def main():
+    parser = argument_parser('statistics of the passes of ifcc over a corpus')
+    parser.add_argument('paths', metavar='PATH', nargs='*', default=[os.path.join(HERE, '..', 'testfiles')])
+    parser.add_argument('--flags', default='-O2', help='options given to ifcc')
+    args = parser.parse_args()
+
+    files = sources(args.paths)
+    with tempfile.TemporaryDirectory() as tmp:
+        manifest = os.path.join(tmp, 'manifest')
+        with open(manifest, 'w') as m:
+            for i, source in enumerate(files):
+                m.write('%s:%s\n' % (source, os.path.join(tmp, '%d.s' % i)))
+        result = subprocess.run([args.ifcc] + args.flags.split() + ['--report-passes', '--batch', '@' + manifest],
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+    # chaque fichier a son rapport, ses lignes préfixées par le nom du fichier : "f.c: dce  2  5  0.070  0"
+    totals = {}
+    rejected = 0
+    for line in result.stdout.decode(errors='replace').splitlines():
+        fields = line.rsplit(': ', 1)[-1].split()
+        if line.endswith('exit status 0'):
+            continue
+        if 'exit status' in line:
+            rejected += 1
+        elif len(fields) == 5 and fields[1].isdigit():
+            total = totals.setdefault(fields[0], [0, 0, 0.0, 0])
+            for i, field in enumerate(fields[1:]):
+                total[i] += float(field) if i == 2 else int(field)
+
+    print('%d files, %d rejected, %s' % (len(files), rejected, args.flags))
+    print('%-20s%8s%10s%12s%13s' % ('pass', 'runs', 'changes', 'time (ms)', 'over budget'))
+    for name, (runs, changes, time, over) in totals.items():
+        print('%-20s%8d%10d%12.3f%13d' % (name, runs, changes, time, over))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+# Compile chaque fichier avec les deux front ends (ANTLR et --frontend=native) et vérifie qu'ils donnent
+# le même statut, le même assembleur et les mêmes avertissements et erreurs.
+# Seul le texte des erreurs de syntaxe diffère d'un front end à l'autre : pour un fichier que
+# l'analyse ANTLR rejette, on ne compare que le statut.
+#
+# usage : python3 frontend-diff.py [--ifcc ../compiler/ifcc] [--flags="-O0 -O1 -O2"] [PATH...]
+
+import argparse
+import os
+import subprocess
+import sys
+
+from benchmarks.common import sources
+
+
+def compile(ifcc, flags, source):
+    result = subprocess.run([ifcc] + flags + [source], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    return result.returncode, result.stdout, result.stderr
+
+
+def main():
+    here = os.path.dirname(os.path.realpath(__file__))
+    parser = argparse.ArgumentParser(description='compare the ANTLR and native front ends of ifcc')
+    parser.add_argument('paths', metavar='PATH', nargs='*', default=[os.path.join(here, 'testfiles')])
+    parser.add_argument('--ifcc', default=os.path.join(here, '..', 'compiler', 'ifcc'))
+    parser.add_argument('--flags', default='-O0 -O1 -O2', help='optimization levels to compare')
+    args = parser.parse_args()
+
+    files = sources(args.paths)
+    mismatches = 0
+    for level in args.flags.split():
+        for source in files:
+            antlr = compile(args.ifcc, [level], source)
+            native = compile(args.ifcc, [level, '--frontend=native'], source)
+            if b'syntax error during parsing' in antlr[2]:
+                same = antlr[0] == native[0]
+            else:
+                same = antlr == native
+            if not same:
+                mismatches += 1
+                print('%s %s: front ends differ (status %d / %d)' % (level, source, antlr[0], native[0]))
+                if antlr[2] != native[2]:
+                    sys.stdout.write('  antlr:  %s\n  native: %s\n' % (antlr[2].decode(errors='replace').strip(),
+                                                                       native[2].decode(errors='replace').strip()))
+
+    print('%d files x %d levels, %d mismatches' % (len(files), len(args.flags.split()), mismatches))
+    return 1 if mismatches else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
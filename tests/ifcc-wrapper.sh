@@ -15,10 +15,13 @@
 
 # Warning: you have to forward the exit status of your compiler back to the harness
 
+# Options for the compiler (e.g. the optimization level) can be given in the IFCC_FLAGS
+# environment variable: IFCC_FLAGS=-O2 python3 ifcc-test.py testfiles/
+
 DESTNAME=$1
 SOURCENAME=$2
 
-$(dirname $0)/../compiler/ifcc $SOURCENAME >$DESTNAME
+$(dirname $0)/../compiler/ifcc $IFCC_FLAGS $SOURCENAME >$DESTNAME
 retcode=$?
 
 # forward exit status of the compiler
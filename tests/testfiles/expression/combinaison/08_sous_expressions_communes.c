@@ -0,0 +1,19 @@
+int f(int a, int b) {
+    int x = a * b + b * a;
+    int y = 0;
+    if (a < b) {
+        y = (b > a) + a * b;
+    } else {
+        y = (a >= b) - (b - a);
+    }
+    while (a * b > y) {
+        y = y + (a * b) / 3 + 1;
+    }
+    return x + y + (a - b) - (b - a);
+}
+
+int main() {
+    putchar(48 + f(1, 2));
+    putchar(48 + f(2, 1) / 2);
+    return f(3, 4) + f(5, 2);
+}
@@ -0,0 +1,25 @@
+int sum(int a, int b, int n) {
+    int s = 0;
+    for (int i = 0; i < n * 2; i++) {
+        int k = a * b + 3;
+        s = s + k + i / 4;
+        for (int j = 0; j < a + b; j++) {
+            s = s + (a - b) * 2;
+        }
+    }
+    return s;
+}
+
+int divide(int a, int b, int n) {
+    int s = 0;
+    for (int i = 0; i < n; i++) {
+        s = s + a / b + a % b;
+    }
+    return s;
+}
+
+int main() {
+    putchar(sum(1, 2, 3) + 20);
+    putchar(divide(100, 7, 3));
+    return sum(3, 4, 5) + divide(5, 0, 0);
+}
@@ -0,0 +1,54 @@
+int somme(int debut, int n) {
+    int s = 0;
+    for (int i = debut; i < n; i++) {
+        s = s + i * 3;
+    }
+    return s;
+}
+
+int pas(int n) {
+    int s = 0;
+    for (int i = n; i >= -5; i -= 2) {
+        s = s * 3 + i;
+    }
+    for (int j = 1; j <= n; j += 3) {
+        s = s ^ j;
+    }
+    return s;
+}
+
+int bornes(int n) {
+    int s = 0;
+    int haut = 2147483647 - n;
+    int bas = -2147483647 + n;
+    int presque = haut - 1;
+    for (int i = 2147483640; i < haut; i++) {
+        s = s + 1;
+    }
+    for (int i = -2147483647 - 1; i < bas; i++) {
+        s = s + 2;
+    }
+    for (int j = 2147483647; j > presque; j--) {
+        s = s + 5;
+    }
+    return s;
+}
+
+int main() {
+    int s = 0;
+    int i = 5;
+    while (i > 0) {
+        i--;
+        if (s & 1)
+            s = s + 3;
+        s = s + i;
+    }
+    for (i = 0; i < 4; i++) {
+        s = s * 2 + i;
+    }
+    for (i = 0; i < 9; i++) {
+        putchar(48 + (somme(i, 9) + pas(i)) % 10);
+    }
+    putchar(10);
+    return (s + somme(-3, 10) + bornes(0) + bornes(1)) % 256;
+}
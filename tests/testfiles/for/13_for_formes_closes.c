@@ -0,0 +1,58 @@
+int somme(int debut, int fin) {
+    int s = 0;
+    int i;
+    for (i = debut; i < fin; i++) {
+        s = s + i;
+    }
+    return s * 7 + i;
+}
+
+int produit(int n, int k) {
+    int s = 1;
+    for (int i = 0; i < n; i++) {
+        s += i * k + 2;
+    }
+    return s;
+}
+
+int descente(int n) {
+    int s = 0;
+    int t = 0;
+    while (n >= 0) {
+        s = s + 2 * n - 1;
+        t = t + s;
+        n -= 4;
+    }
+    return s - n;
+}
+
+int imbriquees(int n, int m) {
+    int s = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            s = s + j + 3;
+        }
+    }
+    return s;
+}
+
+int grands(int n) {
+    int s = 0;
+    int haut = 2147483647 - n;
+    int i;
+    for (i = 2147483000; i <= haut - 8; i += 8) {
+        s = s + i;
+    }
+    return s ^ i;
+}
+
+int main() {
+    for (int i = -3; i < 6; i++) {
+        putchar(48 + (somme(i, 9) & 7) + (produit(i, i - 2) & 1));
+    }
+    putchar(10);
+    int x = somme(5, 2) + somme(-100000, 100000) + produit(50000, 3) + produit(1000, -7);
+    x = x + descente(29) + descente(-1) + imbriquees(6, 9) + imbriquees(3000, 2000);
+    x = x + grands(0) + grands(5) + grands(8);
+    return x & 255;
+}
@@ -0,0 +1,9 @@
+int f(int a, int b, int c, int d, int e, int g, int h, int i) {
+    g = h;
+    e = i + 1;
+    return a + b + c + d + e + g + h + i;
+}
+
+int main() {
+    return f(1, 2, 3, 4, 5, 6, 7, 8);
+}
@@ -0,0 +1,19 @@
+int main() {
+    int a = 3;
+    int b = 7;
+    int r = 0;
+    if (a < b && b < 10 && a != 0)
+        r = r + 1;
+    if (a > b || b == 7 || a == 0)
+        r = r + 2;
+    if (a > b && b == 7)
+        r = r + 4;
+    int c = a < b;
+    if (c)
+        r = r + 8;
+    while (a < 10 && (b > 0 || a == 5)) {
+        a = a + 1;
+        b = b - 2;
+    }
+    return r * 10 + a;
+}
@@ -0,0 +1,13 @@
+int value(int x) {
+    return x;
+}
+
+int main() {
+    int a = 0;
+    int b = 8;
+    if (b) {
+        a = b * value(3);
+    }
+    a += (35 && a);
+    return a;
+}
@@ -0,0 +1,20 @@
+int value(int x) {
+    return x;
+}
+
+int main() {
+    int a = value(120);
+    int b = a;
+    int c = -b;
+    int d = b++;
+    int e = ++d;
+    int f = e;
+    while (f < a + 5) {
+        int g = f;
+        f = g + 1;
+        e = -c;
+    }
+    putchar(c + 2 * a);
+    putchar(e);
+    return a + b + d + f;
+}
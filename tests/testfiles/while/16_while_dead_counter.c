@@ -0,0 +1,14 @@
+int main() {
+    int i = 0;
+    int dead = 3;
+    int kept = 1;
+    while (i < 6) {
+        dead = dead * 5 + i;
+        kept = kept + i;
+        putchar('a' + i);
+        i = i + 1;
+    }
+    dead = 7;
+    kept = kept * 2;
+    return kept;
+}
@@ -0,0 +1,18 @@
+int main() {
+    int n = 0;
+    int i = 0;
+    while (i < 5 && n < 8) {
+        i++;
+        if (i == 2)
+            continue;
+        n = n + i;
+    }
+    int m = 0;
+    for (int j = n; j < 3; j++)
+        m = m + 100;
+    for (int a = 0; a < 3; a++)
+        for (int b = a; b < 4; b++)
+            m = m + a * b;
+    putchar(48 + i);
+    return n + m;
+}
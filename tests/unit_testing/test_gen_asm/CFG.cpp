@@ -2,16 +2,13 @@
 int CFG::get_var_index(string name) {
     return 0;
 }
-string CFG::IR_reg_to_asm(string reg) {
-    if(reg=="var_out") {
-        return "-16(%rbp)";
+string CFG::IR_reg_to_asm(const Operand & reg) const {
+    if(reg.is_immediate()) {
+        return "$" + to_string(reg.get_value());
     }
-    if(reg=="var_in1") {
-        return "-20(%rbp)";
-    }
-    if(reg=="var_in2") {
-        return "-24(%rbp)";
-    }
-    return "error";
-    
-}
\ No newline at end of file
+    return to_string(reg.get_index()) + "(%rbp)";
+}
+
+bool CFG::is_in_register(const Operand & reg) const {
+    return false;
+}
@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
+#include "../../../compiler/Operand.h"
 using namespace std;
 class CFG {
  public:
-	string IR_reg_to_asm(string reg);
+	string IR_reg_to_asm(const Operand & reg) const;
+	bool is_in_register(const Operand & reg) const;
     int get_var_index(string name);
 };
\ No newline at end of file
@@ -4,6 +4,8 @@ using namespace std;
 #include <fstream>
 #include <cstdlib>
 #include <ctime>
+#include <climits>
+#include <vector>
 
 #include "../../../compiler/IRInstr.h"
 #include "CFG.h"
@@ -11,6 +13,10 @@ using namespace std;
 #include "helper.h"
 #include "../helper.h"
 
+const Operand VAR_OUT = Operand::variable(-16);
+const Operand VAR_IN1 = Operand::variable(-20);
+const Operand VAR_IN2 = Operand::variable(-24);
+
 bool test_unary(Operation op, int expectedVarOut, int var_out) {
      srand(time(0));             // Initialize random number generator
     int random_number = rand(); // Generate random number
@@ -19,9 +25,9 @@ bool test_unary(Operation op, int expectedVarOut, int var_out) {
     std::ofstream o(filename + ".s");
     CFG *cfg = new CFG();
     BasicBlock *bb = new BasicBlock(cfg);
-    IRInstr load_var_out = IRInstr(bb, Operation::ldconst, {"var_out", to_string(var_out)});
-    IRInstr instr_to_test = IRInstr(bb, op, {"var_out"});
-    IRInstr returnInstr = IRInstr(bb, Operation::ret, {"var_out"});
+    IRInstr load_var_out = IRInstr(bb, Operation::ldconst, {VAR_OUT, Operand::immediate(var_out)});
+    IRInstr instr_to_test = IRInstr(bb, op, {VAR_OUT});
+    IRInstr returnInstr = IRInstr(bb, Operation::ret, {VAR_OUT});
 
     try
     {
@@ -76,7 +82,7 @@ bool test_unary(Operation op, int expectedVarOut, int var_out) {
     return true;
 }
 
-bool test_ternary(Operation op, int expectedVarOut, int varIn1, int varIn2)
+bool test_ternary(Operation op, int expectedVarOut, int varIn1, int varIn2, bool immediateIn2 = false)
 {
     srand(time(0));             // Initialize random number generator
     int random_number = rand(); // Generate random number
@@ -85,10 +91,10 @@ bool test_ternary(Operation op, int expectedVarOut, int varIn1, int varIn2)
     std::ofstream o(filename + ".s");
     CFG *cfg = new CFG();
     BasicBlock *bb = new BasicBlock(cfg);
-    IRInstr load_var1 = IRInstr(bb, Operation::ldconst, {"var_in1", to_string(varIn1)});
-    IRInstr load_var2 = IRInstr(bb, Operation::ldconst, {"var_in2", to_string(varIn2)});
-    IRInstr instr_to_test = IRInstr(bb, op, {"var_out", "var_in1", "var_in2"});
-    IRInstr returnInstr = IRInstr(bb, Operation::ret, {"var_out"});
+    IRInstr load_var1 = IRInstr(bb, Operation::ldconst, {VAR_IN1, Operand::immediate(varIn1)});
+    IRInstr load_var2 = IRInstr(bb, Operation::ldconst, {VAR_IN2, Operand::immediate(varIn2)});
+    IRInstr instr_to_test = IRInstr(bb, op, {VAR_OUT, VAR_IN1, immediateIn2 ? Operand::immediate(varIn2) : VAR_IN2});
+    IRInstr returnInstr = IRInstr(bb, Operation::ret, {VAR_OUT});
 
     try
     {
@@ -144,6 +150,122 @@ bool test_ternary(Operation op, int expectedVarOut, int varIn1, int varIn2)
     return true;
 }
 
+// mul, divide et modulo par une constante : une fonction par opération et par constante, appelée par un
+// programme C sur des valeurs aux limites des int, comparée au calcul de gcc
+bool test_constant_operands()
+{
+    vector<int> constants;
+    for (int c = -1100; c <= 1100; c++)
+        constants.push_back(c);
+    for (int k = 11; k < 31; k++)
+        for (int c : {1 << k, (1 << k) - 1, (1 << k) + 1, 3 << (k - 1), 5 << (k - 2), 9 << (k - 3)})
+        {
+            constants.push_back(c);
+            constants.push_back(-c);
+        }
+    for (int c : {INT_MIN, INT_MIN + 1, INT_MAX, INT_MAX - 1, 1000000007, -1000000007, 641, 6700417, 715827883, -715827883, 1431655765, 123456789})
+        constants.push_back(c);
+
+    srand(time(0));
+    std::string filename = "/tmp/tmp_gen_asm" + std::to_string(rand());
+    string cleanup_command = "rm -f " + filename + ".s " + filename + "_main.c " + filename;
+    std::ofstream o(filename + ".s");
+    std::ofstream driver(filename + "_main.c");
+    CFG *cfg = new CFG();
+    BasicBlock *bb = new BasicBlock(cfg);
+    o << ".section .note.GNU-stack\n.section .text\n";
+    driver << "#include <limits.h>\n#include <stdio.h>\n";
+    Operation operations[] = {mul, divide, modulo};
+    int count = 0;
+    for (int c : constants)
+        for (int i = 0; i < 3; i++)
+        {
+            if (operations[i] != mul && c == 0)
+                continue;
+            // le facteur constant aussi en premier opérande
+            bool swapped = operations[i] == mul && c % 2 != 0;
+            IRInstr instr = IRInstr(bb, operations[i], {VAR_OUT, swapped ? Operand::immediate(c) : VAR_IN1, swapped ? VAR_IN1 : Operand::immediate(c)});
+            o << ".globl f" << count << "\nf" << count << ":\n";
+            o << "pushq %rbp\nmovq %rsp, %rbp\nsubq $64, %rsp\n";
+            o << "movl %edi, " << VAR_IN1.get_index() << "(%rbp)\n";
+            instr.gen_asm(o);
+            o << "movl " << VAR_OUT.get_index() << "(%rbp), %eax\nmovq %rbp, %rsp\npopq %rbp\nret\n";
+            driver << "int f" << count << "(int);\n";
+            count++;
+        }
+    o.close();
+
+    driver << "int (*functions[])(int) = {";
+    for (int i = 0; i < count; i++)
+        driver << "f" << i << ",";
+    driver << "};\nint constants[] = {";
+    for (int c : constants)
+        driver << "(" << c << ")" << ",";
+    driver << "};\n";
+    driver << R"(
+int mismatches = 0;
+
+int check(int (*f)(int), int operation, int c, int x)
+{
+    int expected;
+    if (operation == 0)
+        expected = (int)((unsigned)x * (unsigned)c);
+    else if (x == INT_MIN && c == -1)
+        return 1;
+    else
+        expected = operation == 1 ? x / c : x % c;
+    int result = f(x);
+    if (result != expected && mismatches++ < 10)
+        printf("%s by %d of %d: %d instead of %d\n", operation == 0 ? "mul" : operation == 1 ? "divide" : "modulo", c, x, result, expected);
+    return result == expected;
+}
+
+int main()
+{
+    int limits[] = {INT_MIN, INT_MIN + 1, INT_MIN + 2, INT_MAX, INT_MAX - 1, INT_MAX - 2, 0, 1, -1, 2, -2};
+    int n = 0;
+    unsigned random = 12345;
+    for (unsigned i = 0; i < sizeof(constants) / sizeof(int); i++)
+        for (int operation = 0; operation < 3; operation++)
+        {
+            int c = constants[i];
+            if (operation != 0 && c == 0)
+                continue;
+            int (*f)(int) = functions[n++];
+            int ok = 1;
+            for (unsigned j = 0; j < sizeof(limits) / sizeof(int); j++)
+                ok &= check(f, operation, c, limits[j]);
+            for (int x = -300; x <= 300; x++)
+                ok &= check(f, operation, c, x);
+            // autour des multiples de c et des limites qu'ils atteignent
+            for (int k = -3; k <= 3; k++)
+                for (int d = -1; d <= 1; d++)
+                {
+                    ok &= check(f, operation, c, (int)((unsigned)k * (unsigned)c + (unsigned)d));
+                    ok &= check(f, operation, c, (int)((unsigned)(c == 0 ? 1 : INT_MAX / c) * (unsigned)c + (unsigned)(k + d)));
+                }
+            for (int j = 0; j < 200; j++)
+            {
+                random = random * 1103515245u + 12345u;
+                ok &= check(f, operation, c, (int)(random ^ (random >> 13)));
+            }
+            if (!ok)
+                return 1;
+        }
+    return 0;
+}
+)";
+    driver.close();
+
+    string build_command = "gcc -O1 -o " + filename + " " + filename + ".s " + filename + "_main.c";
+    bool success = system(build_command.c_str()) >> 8 == 0 && system(filename.c_str()) >> 8 == 0;
+    if (!success)
+        cerr << "the assembly of " << filename << ".s does not compute the expected values" << endl;
+    else
+        system(cleanup_command.c_str());
+    return success;
+}
+
 int main()
 {
     bool success = true;
@@ -300,6 +422,26 @@ int main()
         success = false;
     }
 
+    if (test_ternary(add, 7, 5, 2, true) && test_ternary(sub, 11, 30, 19, true) && test_ternary(mul, 30, -6, -5, true) && test_ternary(divide, 5, -10, -2, true) && test_ternary(modulo, 3, 8, 5, true) && test_ternary(cmp_lt, 1, -3, 5, true) && test_ternary(cmp_ge, 0, -3, 5, true) && test_ternary(bwsl, 24, 3, 3, true) && test_ternary(bwsr, 2, 17, 3, true))
+    {
+        cout << "[test_gen_asm] test_immediate " << green_check_mark() << endl;
+    }
+    else
+    {
+        cerr << "[test_gen_asm] test_immediate " << red_cross() << endl;
+        success = false;
+    }
+
+    if (test_constant_operands())
+    {
+        cout << "[test_gen_asm] test_constant_operands " << green_check_mark() << endl;
+    }
+    else
+    {
+        cerr << "[test_gen_asm] test_constant_operands " << red_cross() << endl;
+        success = false;
+    }
+
     if (success)
     {
         cout << "test_gen_asm " << green_check_mark() << endl;